@@ -0,0 +1,266 @@
+/*
+  ==============================================================================
+
+    AmpProfile.cpp
+    Created: 23 Oct 2026 9:26:15am
+    Author:  dkuzn
+
+  ==============================================================================
+*/
+
+#include "AmpProfile.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#ifndef M_PI
+namespace
+{
+    const double M_PI = std::acos(-1.0);
+}
+#endif
+
+namespace
+{
+    constexpr uint32_t curveSize = 256u; // lookup grid points over [0, ampMax]
+
+    template <typename T>
+    bool read(const uint8_t*& p, const uint8_t* end, T& value)
+    {
+        if ((size_t)(end - p) < sizeof(T))
+            return false;
+
+        std::memcpy(&value, p, sizeof(T));
+        p += sizeof(T);
+        return true;
+    }
+
+    template <typename T>
+    void write(std::vector<uint8_t>& out, const T& value)
+    {
+        const uint8_t* p = reinterpret_cast<const uint8_t*>(&value);
+        out.insert(out.end(), p, p + sizeof(T));
+    }
+}
+
+bool AmpProfile::parse(const void* data, size_t size)
+{
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    const uint8_t* end = p + size;
+
+    char magic[4];
+    uint32_t fileVersion = 0;
+    uint32_t fileBands = 0;
+    uint32_t steps = 0;
+
+    if (size < sizeof(magic) || std::memcmp(p, "DKAP", sizeof(magic)) != 0)
+        return false;
+    p += sizeof(magic);
+
+    if (!read(p, end, fileVersion) || !read(p, end, fileBands) || !read(p, end, steps))
+        return false;
+
+    if (fileVersion != version || fileBands != numBands || steps < 2u || steps > 65536u)
+        return false;
+
+    AmpProfile profile;
+    profile.numSteps = steps;
+
+    if (!read(p, end, profile.ampMin) || !read(p, end, profile.ampMax))
+        return false;
+
+    for (auto& hz : profile.bandHz)
+    {
+        if (!read(p, end, hz))
+            return false;
+    }
+
+    for (auto& hz : profile.crossoverHz)
+    {
+        if (!read(p, end, hz))
+            return false;
+    }
+
+    // NaN / inf would end up in the curves and crossover coefficients
+    if (!(profile.ampMin >= 0.0f && profile.ampMax > profile.ampMin && std::isfinite(profile.ampMax)))
+        return false;
+
+    for (float hz : profile.bandHz)
+    {
+        if (!(hz > 0.0f && std::isfinite(hz)))
+            return false;
+    }
+
+    if (!(profile.crossoverHz[0] > 0.0f && profile.crossoverHz[1] > profile.crossoverHz[0]
+        && std::isfinite(profile.crossoverHz[1])))
+        return false;
+
+    profile.gain.resize((size_t)numBands * steps);
+    for (auto& g : profile.gain)
+    {
+        if (!read(p, end, g) || !std::isfinite(g))
+            return false;
+    }
+
+    *this = std::move(profile);
+    return true;
+}
+
+std::vector<uint8_t> AmpProfile::serialize() const
+{
+    std::vector<uint8_t> out;
+    out.insert(out.end(), { 'D', 'K', 'A', 'P' });
+
+    write(out, version);
+    write(out, numBands);
+    write(out, numSteps);
+    write(out, ampMin);
+    write(out, ampMax);
+
+    for (float hz : bandHz)
+        write(out, hz);
+
+    for (float hz : crossoverHz)
+        write(out, hz);
+
+    for (float g : gain)
+        write(out, g);
+
+    return out;
+}
+
+AmpProfileStage::AmpProfileStage()
+{
+}
+
+void AmpProfileStage::setProfile(const AmpProfile& profile)
+{
+    if (profile.numSteps < 2u || profile.gain.size() != (size_t)AmpProfile::numBands * profile.numSteps)
+    {
+        clearProfile();
+        return;
+    }
+
+    this->profile = profile;
+    loaded = true;
+    publish();
+}
+
+void AmpProfileStage::clearProfile()
+{
+    loaded = false;
+    shapes.invalidate();
+}
+
+void AmpProfileStage::prepare(double sampleRate)
+{
+    this->sampleRate = sampleRate;
+    publish();
+}
+
+void AmpProfileStage::reset()
+{
+    resetPending = true;
+}
+
+void AmpProfileStage::publish()
+{
+    if (!loaded || sampleRate <= 0.0)
+    {
+        shapes.invalidate();
+        return;
+    }
+
+    // 3 x 257 points, built here and swapped in for the audio thread
+    const AmpProfile p = profile;
+    const double rate = sampleRate;
+
+    shapes.build([p, rate] { return buildShape(p, rate); });
+}
+
+AmpProfileStage::Shape AmpProfileStage::buildShape(const AmpProfile& profile, double sampleRate)
+{
+    Shape s;
+
+    const float stepIn = (profile.ampMax - profile.ampMin) / (float)(profile.numSteps - 1u);
+
+    for (uint32_t b = 0; b < AmpProfile::numBands; ++b)
+    {
+        const float* g = &profile.gain[(size_t)b * profile.numSteps];
+        Curve& c = s.curves[b];
+
+        c.invStep = (float)(curveSize - 1u) / profile.ampMax;
+        c.y.resize(curveSize + 1u);
+
+        for (uint32_t k = 0; k < curveSize; ++k)
+        {
+            float a = profile.ampMax * (float)k / (float)(curveSize - 1u);
+            float x = std::min(std::max((a - profile.ampMin) / stepIn, 0.0f), (float)(profile.numSteps - 1u));
+            uint32_t i = std::min((uint32_t)x, profile.numSteps - 2u);
+            float f = x - (float)i;
+
+            c.y[k] = a * (g[i] + f * (g[i + 1u] - g[i]));
+        }
+
+        c.y[curveSize] = c.y[curveSize - 1u];
+    }
+
+    // crossovers stay below Nyquist (the file is measured at an unknown rate)
+    const double maxHz = 0.45 * sampleRate;
+
+    s.lowCoeff = (float)(1.0 - std::exp(-2.0 * M_PI * std::min((double)profile.crossoverHz[0], maxHz) / sampleRate));
+    s.midCoeff = (float)(1.0 - std::exp(-2.0 * M_PI * std::min((double)profile.crossoverHz[1], maxHz) / sampleRate));
+
+    return s;
+}
+
+// |x| beyond the grid lands on the last point (held output), no branches
+inline float AmpProfileStage::Curve::shape(float x) const
+{
+    const float last = (float)(curveSize - 1u);
+
+    float p = std::min(last, std::fabs(x) * invStep); // NaN -> last
+    int32_t k = (int32_t)p;
+    float f = p - (float)k;
+
+    return std::copysign(y[k] + f * (y[k + 1] - y[k]), x);
+}
+
+bool AmpProfileStage::processBlock(float* samples, int numSamples)
+{
+    bool changed = false;
+    const Shape* s = shapes.acquire(&changed);
+
+    if (s == nullptr)
+        return false;
+
+    // crossover states of another rate / profile are not carried over
+    if (changed || resetPending)
+    {
+        lowState = 0.0f;
+        midState = 0.0f;
+        resetPending = false;
+    }
+
+    const float lowCoeff = s->lowCoeff;
+    const float midCoeff = s->midCoeff;
+    const Curve* curves = s->curves;
+
+    // low = LP1(x), mid = LP2(x - low), high = the rest; one pass, the
+    // lookups do not feed back, so they overlap with the crossover recursion
+    float lp1 = lowState;
+    float lp2 = midState;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        lp1 += lowCoeff * (samples[i] - lp1);
+        float rest = samples[i] - lp1;
+        lp2 += midCoeff * (rest - lp2);
+
+        samples[i] = curves[0].shape(lp1) + curves[1].shape(lp2) + curves[2].shape(rest - lp2);
+    }
+
+    lowState = lp1;
+    midState = lp2;
+    return true;
+}
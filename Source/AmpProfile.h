@@ -0,0 +1,105 @@
+/*
+  ==============================================================================
+
+    AmpProfile.h
+    Created: 23 Oct 2026 9:26:15am
+    Author:  dkuzn
+
+    Measured amp profiles (transitionGen.py / dkAmpTools fit-profile) and the
+    3-band waveshaper that plays them.
+
+    .dkap file, little endian:
+        char[4]   "DKAP"
+        uint32    version (1)
+        uint32    numBands (3)
+        uint32    numSteps
+        float     ampMin, ampMax       tone amplitude of the first / last step (full scale = 1)
+        float     bandHz[numBands]     measurement tone of each band
+        float     crossoverHz[numBands - 1]
+        float     gain[numBands][numSteps]   |out| / |in| per amplitude step
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "BackgroundTable.h"
+
+
+struct AmpProfile
+{
+    static constexpr uint32_t numBands = 3u;
+    static constexpr uint32_t version = 1u;
+
+    uint32_t numSteps = 0;
+    float ampMin = 0.0f;
+    float ampMax = 0.0f;
+    float bandHz[numBands] = { 200.0f, 1000.0f, 8000.0f };
+    float crossoverHz[numBands - 1u] = { 447.0f, 2828.0f };
+    std::vector<float> gain; // numBands * numSteps, band major
+
+    // false if the data is not a valid version 1, 3-band profile
+    bool parse(const void* data, size_t size);
+    std::vector<uint8_t> serialize() const;
+};
+
+
+// Splits the signal into three bands (complementary one-pole crossover,
+// the bands sum back to the input exactly) and shapes every band with its
+// measured curve y = x * g(|x|). Below ampMin the gain of the first step is
+// held, above ampMax the output is held at ampMax * g(ampMax).
+// Profile and sample rate changes (message thread) build a new set of curves
+// and coefficients that the audio thread picks up at the next block.
+class AmpProfileStage
+{
+public:
+    AmpProfileStage();
+
+    // resamples the gain curves to the lookup grid (once prepare() has set the rate)
+    void setProfile(const AmpProfile& profile);
+    void clearProfile();
+    bool hasProfile() const { return loaded; } // message thread
+
+    void prepare(double sampleRate);
+    void reset();
+
+    // audio thread, false (samples untouched) if no profile is loaded
+    bool processBlock(float* samples, int numSamples);
+
+private:
+    // output amplitude y = a * g(a) on a uniform grid over [0, ampMax],
+    // one guard point at the end
+    struct Curve
+    {
+        std::vector<float> y;
+        float invStep = 0.0f;
+
+        float shape(float x) const;
+    };
+
+    // everything processBlock reads, published as a whole
+    struct Shape
+    {
+        Curve curves[AmpProfile::numBands];
+        float lowCoeff = 0.0f;
+        float midCoeff = 0.0f;
+    };
+
+    static Shape buildShape(const AmpProfile& profile, double sampleRate);
+    void publish(); // message thread
+
+    // message thread
+    bool loaded = false;
+    AmpProfile profile;
+    double sampleRate = 0.0;
+
+    BackgroundTable<Shape> shapes;
+
+    // audio thread
+    bool resetPending = true;
+    float lowState = 0.0f;
+    float midState = 0.0f;
+};
@@ -0,0 +1,215 @@
+/*
+  ==============================================================================
+
+    BackgroundTable.h
+    Created: 24 Oct 2026 10:41:03am
+    Author:  dkuzn
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+// Lookup table shared between the message thread and the audio thread.
+// Every request bumps a version; the table is built on a worker thread (started
+// on the first requestBuild) or on the calling thread (build) and swapped in.
+// The audio thread marks the table it reads (hazard pointer), retired tables
+// are deleted only when they are not in use. Tables of older versions are
+// never handed out, so callers fall back to the exact calculation until the
+// table for the latest parameters is ready.
+template <typename T>
+class BackgroundTable
+{
+public:
+    BackgroundTable() = default;
+    ~BackgroundTable();
+
+    BackgroundTable(const BackgroundTable&) = delete;
+    BackgroundTable& operator=(const BackgroundTable&) = delete;
+
+    // parameters changed, but no table is needed for them (yet)
+    void invalidate();
+
+    // builds the table on the worker thread, several requests in a row end up in one build
+    void requestBuild(std::function<T()> builder);
+
+    // builds the table on the calling thread (cheap tables, not the audio thread)
+    void build(const std::function<T()>& builder);
+
+    bool isReady() const { return tableVersion.load() == paramsVersion.load(); }
+
+    // audio thread: nullptr if there is no table for the latest request,
+    // changed is set when the table differs from the one of the previous call
+    const T* acquire(bool* changed = nullptr);
+
+private:
+    struct Node
+    {
+        T table;
+        uint32_t version = 0; // parameters version the table was built for
+    };
+
+    void workerThread();
+    void publish(Node* node); // lock must be held
+    void freeRetired(); // lock must be held
+
+    std::atomic<uint32_t> paramsVersion{ 0 };
+    std::atomic<uint32_t> tableVersion{ 0xffffffffu };
+    std::atomic<Node*> current{ nullptr };
+    std::atomic<Node*> inUse{ nullptr };
+    Node* acquired = nullptr; // audio thread
+    std::vector<Node*> retired;
+
+    std::thread worker;
+    std::mutex lock;
+    std::condition_variable wake;
+    std::function<T()> pending;
+    bool quit = false;
+};
+
+
+template <typename T>
+BackgroundTable<T>::~BackgroundTable()
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        quit = true;
+    }
+    wake.notify_one();
+
+    if (worker.joinable())
+        worker.join();
+
+    delete current.load();
+    for (Node* n : retired)
+        delete n;
+}
+
+template <typename T>
+void BackgroundTable<T>::invalidate()
+{
+    std::lock_guard<std::mutex> guard(lock);
+    paramsVersion.fetch_add(1u);
+    pending = nullptr;
+}
+
+template <typename T>
+void BackgroundTable<T>::requestBuild(std::function<T()> builder)
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        paramsVersion.fetch_add(1u);
+        pending = std::move(builder);
+
+        if (!worker.joinable())
+            worker = std::thread(&BackgroundTable::workerThread, this);
+    }
+    wake.notify_one();
+}
+
+template <typename T>
+void BackgroundTable<T>::build(const std::function<T()>& builder)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    uint32_t version = paramsVersion.fetch_add(1u) + 1u;
+    pending = nullptr;
+
+    publish(new Node{ builder(), version });
+}
+
+template <typename T>
+void BackgroundTable<T>::workerThread()
+{
+    std::unique_lock<std::mutex> guard(lock);
+
+    for (;;)
+    {
+        wake.wait(guard, [this] { return pending != nullptr || quit; });
+        if (quit)
+            break;
+
+        std::function<T()> builder = std::move(pending);
+        pending = nullptr;
+        uint32_t version = paramsVersion.load();
+
+        guard.unlock();
+        Node* node = new Node{ builder(), version };
+        guard.lock();
+
+        // parameters changed during the build, a newer table is on the way (or not needed)
+        if (version != paramsVersion.load())
+        {
+            delete node;
+            continue;
+        }
+
+        publish(node);
+    }
+}
+
+template <typename T>
+void BackgroundTable<T>::publish(Node* node)
+{
+    Node* old = current.exchange(node);
+    tableVersion.store(node->version);
+
+    if (old != nullptr)
+        retired.push_back(old);
+
+    freeRetired();
+}
+
+template <typename T>
+const T* BackgroundTable<T>::acquire(bool* changed)
+{
+    Node* latest = current.load(std::memory_order_acquire);
+
+    // mark the table as used before reading it; if it was replaced in the
+    // meantime, it may already have been deleted -> try again
+    while (latest != acquired)
+    {
+        inUse.store(latest);
+        Node* check = current.load();
+
+        if (check == latest)
+        {
+            acquired = latest;
+            if (changed != nullptr)
+                *changed = true;
+        }
+        else
+            latest = check;
+    }
+
+    if (acquired == nullptr || acquired->version != paramsVersion.load(std::memory_order_relaxed))
+        return nullptr;
+
+    return &acquired->table;
+}
+
+template <typename T>
+void BackgroundTable<T>::freeRetired()
+{
+    Node* used = inUse.load();
+
+    auto it = std::remove_if(retired.begin(), retired.end(), [used](Node* n)
+    {
+        if (n == used)
+            return false;
+
+        delete n;
+        return true;
+    });
+
+    retired.erase(it, retired.end());
+}
@@ -10,6 +10,8 @@
 
 #include "CabSim.h"
 #include <cmath>
+#include <algorithm>
+#include <iterator>
 #include "chirp.h"
 
 #define IR_NORM_FACTOR 0.90f
@@ -19,12 +21,25 @@ AudioLoader::AudioLoader()
     formatManager.registerBasicFormats();
 }
 
+bool AudioLoader::readInfo(const juce::File& file)
+{
+    std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
+    if (reader.get() != nullptr)
+    {
+        fileSampleRate = (uint32_t)(reader->sampleRate);
+        fileLength = (uint32_t)(reader->lengthInSamples);
+        return true;
+    }
+    return false;
+}
+
 bool AudioLoader::loadWavFile(const juce::File& file)
 {
     std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
     if (reader.get() != nullptr)
     {
         fileSampleRate = (uint32_t)(reader->sampleRate);
+        fileLength = (uint32_t)(reader->lengthInSamples);
 
         // Create buffer
         audioBuffer.setSize((int)reader->numChannels, (int)reader->lengthInSamples);
@@ -58,6 +73,7 @@ void FIR_FFT_OLS::setFFTSize(uint32_t size)
 {
     fftSize = size;
     fftSizeHalf = fftSize / 2;
+    fft.prepare(fftSize);
 
     // --- clear buffers that depend on fftSize ---
     inputBufferRe.clear();
@@ -68,9 +84,9 @@ void FIR_FFT_OLS::setFFTSize(uint32_t size)
     overlapBuffer.clear();
     outputBuffer.clear();
 
-    // --- optional: clear FFT segment buffers if re-preparing later ---
-    h_fft_Re.clear();
-    h_fft_Im.clear();
+    // --- IR spectra depend on fftSize, they have to be prepared again ---
+    partitions.reset();
+    numSegments = 0;
     inputFFT_Re.clear();
     inputFFT_Im.clear();
 
@@ -89,43 +105,184 @@ void FIR_FFT_OLS::setFFTSize(uint32_t size)
 
 void FIR_FFT_OLS::prepare(const float* h, uint32_t h_len)
 {
-    IR_len = h_len;
+    setPartitions(createPartitions(h, h_len));
+}
 
-    h_fft_Re.clear();
-    h_fft_Im.clear();
-    inputFFT_Re.clear();
-    inputFFT_Im.clear();
+std::shared_ptr<IRPartitions> FIR_FFT_OLS::createPartitions(const float* h, uint32_t h_len)
+{
+    auto p = std::make_shared<IRPartitions>();
 
-    // --- alocate ring buffers for input FFT  ---
-    numSegments = static_cast<uint32_t>(std::ceil((float)IR_len / (float)fftSizeHalf));
+    p->IR.resize(h_len);
+    std::memcpy(p->IR.data(), h, h_len * sizeof(float));
+
+    buildSpectra(*p);
+
+    return p;
+}
+
+// IR is already in p.IR (e.g. resampled straight into it)
+void FIR_FFT_OLS::buildSpectra(IRPartitions& p)
+{
+    const float* h = p.IR.data();
+    const uint32_t h_len = static_cast<uint32_t>(p.IR.size());
+
+    p.fftSize = fftSize;
+    p.IR_len = h_len;
+    p.numSegments = static_cast<uint32_t>(std::ceil((float)h_len / (float)fftSizeHalf));
 
     // -- alocate FFT segments --
-    h_fft_Re.resize(numSegments, std::vector<float>(fftSize, 0.0f));
-    h_fft_Im.resize(numSegments, std::vector<float>(fftSize, 0.0f));
+    p.h_fft_Re.assign(p.numSegments, std::vector<float>(fftSize, 0.0f));
+    p.h_fft_Im.assign(p.numSegments, std::vector<float>(fftSize, 0.0f));
 
-    for (uint32_t seg = 0; seg < numSegments; ++seg)
+    for (uint32_t seg = 0; seg < p.numSegments; ++seg)
     {
-        std::memset(h_fft_Re[seg].data(), 0, fftSize * sizeof(float));
-        std::memset(h_fft_Im[seg].data(), 0, fftSize * sizeof(float));
-
         uint32_t startIdx = seg * fftSizeHalf;
-        uint32_t copyLength = std::min(IR_len - startIdx, fftSizeHalf);
+        uint32_t copyLength = std::min(h_len - startIdx, fftSizeHalf);
         if (copyLength > 0)
-            std::memcpy(h_fft_Re[seg].data(), &h[startIdx], copyLength * sizeof(float));
+            std::memcpy(p.h_fft_Re[seg].data(), &h[startIdx], copyLength * sizeof(float));
 
-        fft.FFT_process(h_fft_Re[seg].data(), h_fft_Im[seg].data(), fftSize);
+        fft.FFT_process(p.h_fft_Re[seg].data(), p.h_fft_Im[seg].data(), fftSize);
     }
+}
+
+void FIR_FFT_OLS::setPartitions(std::shared_ptr<const IRPartitions> newPartitions)
+{
+    partitions = std::move(newPartitions);
+
+    IR_len = partitions->IR_len;
+    numSegments = partitions->numSegments;
+
+    inputFFT_Re.clear();
+    inputFFT_Im.clear();
 
+    // --- alocate ring buffers for input FFT  ---
     inputFFT_Re.resize(numSegments, std::vector<float>(fftSize, 0.0f));
     inputFFT_Im.resize(numSegments, std::vector<float>(fftSize, 0.0f));
- 
-    for (uint32_t i = 0; i < numSegments; ++i)
+
+    classifyPartitions();
+
+    fftRingPos = 0u;
+}
+
+void FIR_FFT_OLS::setSparseErrorBound(float bound)
+{
+    sparseErrorBound = std::max(bound, 0.0f);
+
+    if (partitions)
+        classifyPartitions();
+}
+
+float FIR_FFT_OLS::getSkipRatio() const
+{
+    return skipRatio;
+}
+
+uint32_t FIR_FFT_OLS::getFFTSize() const
+{
+    return fftSize;
+}
+
+uint32_t FIR_FFT_OLS::getNumSegments() const
+{
+    return numSegments;
+}
+
+// Decide which partitions and high frequency bins can be left out of the MAC loop.
+// Half of the error budget (sparseErrorBound * IR energy) is spent on whole
+// partitions with the lowest energy, the rest is split between remaining
+// partitions and used to cut their highest bins.
+void FIR_FFT_OLS::classifyPartitions()
+{
+    const uint32_t allBins = fftSizeHalf + 1u; // real IR -> bins above N/2 are mirrored
+
+    activeBins.assign(numSegments, allBins);
+    skipRatio = 0.0f;
+
+    if (numSegments == 0 || sparseErrorBound <= 0.0f)
+        return;
+
+    // energy of every bin pair (k and N - k) for each partition
+    std::vector<std::vector<double>> binEnergy(numSegments, std::vector<double>(allBins, 0.0));
+    std::vector<double> segEnergy(numSegments, 0.0);
+    double totalEnergy = 0.0;
+
+    for (uint32_t seg = 0; seg < numSegments; ++seg)
+    {
+        const float* Hre = partitions->h_fft_Re[seg].data();
+        const float* Him = partitions->h_fft_Im[seg].data();
+
+        for (uint32_t k = 0; k < allBins; ++k)
+        {
+            double e = (double)Hre[k] * Hre[k] + (double)Him[k] * Him[k];
+            if (k != 0 && k != fftSizeHalf)
+                e *= 2.0;
+
+            binEnergy[seg][k] = e;
+            segEnergy[seg] += e;
+        }
+
+        totalEnergy += segEnergy[seg];
+    }
+
+    double budget = sparseErrorBound * totalEnergy;
+
+    // 1. skip whole partitions, starting from the quietest one
+    std::vector<uint32_t> order(numSegments);
+    for (uint32_t seg = 0; seg < numSegments; ++seg)
+        order[seg] = seg;
+
+    std::sort(order.begin(), order.end(), [&segEnergy](uint32_t a, uint32_t b) {
+        return segEnergy[a] < segEnergy[b];
+        });
+
+    double dropped = 0.0;
+    uint32_t numActive = numSegments;
+
+    for (uint32_t seg : order)
     {
-        std::memset(inputFFT_Re[i].data(), 0, fftSize * sizeof(float));
-        std::memset(inputFFT_Im[i].data(), 0, fftSize * sizeof(float));
+        if (numActive <= 1 || dropped + segEnergy[seg] > 0.5 * budget)
+            break;
+
+        dropped += segEnergy[seg];
+        activeBins[seg] = 0;
+        --numActive;
     }
 
-    fftRingPos = 0u;
+    // 2. cut high bins of the remaining partitions
+    double binBudget = (budget - dropped) / numActive;
+
+    for (uint32_t seg = 0; seg < numSegments; ++seg)
+    {
+        if (activeBins[seg] == 0)
+            continue;
+
+        double tail = 0.0;
+        uint32_t n = allBins;
+
+        while (n > 1 && tail + binEnergy[seg][n - 1] <= binBudget)
+        {
+            tail += binEnergy[seg][n - 1];
+            --n;
+        }
+
+        activeBins[seg] = n;
+    }
+
+    // report how much of the full MAC work is left out
+    uint64_t usedBins = 0;
+    for (uint32_t seg = 0; seg < numSegments; ++seg)
+    {
+        if (activeBins[seg] > 0)
+            usedBins += std::min(2u * activeBins[seg] - 1u, fftSize);
+    }
+
+    skipRatio = 1.0f - (float)((double)usedBins / ((double)numSegments * fftSize));
+}
+
+void FIR_FFT_OLS::releasePartitions()
+{
+    partitions.reset();
+    numSegments = 0;
 }
 
 void FIR_FFT_OLS::setNormFactor(float value)
@@ -133,6 +290,11 @@ void FIR_FFT_OLS::setNormFactor(float value)
     normFactor = value;
 }
 
+float FIR_FFT_OLS::getNormFactor() const
+{
+    return normFactor;
+}
+
 void FIR_FFT_OLS::clearBuffers()
 {
     std::fill(inputBufferRe.begin(), inputBufferRe.end(), 0.0f);
@@ -186,10 +348,24 @@ float FIR_FFT_OLS::process(float input)
             // multiply X_idx * H_seg and accumulate
             float* Xre = inputFFT_Re[idx].data();
             float* Xim = inputFFT_Im[idx].data();
-            float* Hre = h_fft_Re[seg].data();
-            float* Him = h_fft_Im[seg].data();
+            const float* Hre = partitions->h_fft_Re[seg].data();
+            const float* Him = partitions->h_fft_Im[seg].data();
 
-            for (uint32_t k = 0; k < fftSize; ++k)
+            // low energy partitions and high bins are skipped (see classifyPartitions)
+            uint32_t n = activeBins[seg];
+            if (n == 0)
+                continue;
+
+            for (uint32_t k = 0; k < n; ++k)
+            {
+                float tmpRe = Xre[k] * Hre[k] - Xim[k] * Him[k];
+                float tmpIm = Xre[k] * Him[k] + Xim[k] * Hre[k];
+                mulBufferRe[k] += tmpRe;
+                mulBufferIm[k] += tmpIm;
+            }
+
+            // mirrored bins (Nyquist bin is already done when n covers it)
+            for (uint32_t k = std::max(n, fftSize - n + 1u); k < fftSize; ++k)
             {
                 float tmpRe = Xre[k] * Hre[k] - Xim[k] * Him[k];
                 float tmpIm = Xre[k] * Him[k] + Xim[k] * Hre[k];
@@ -230,25 +406,146 @@ float FIR_FFT_OLS::process(float input)
     return out;
 }
 
-Convolver::Convolver() : IR(nullptr)
+FIR_Direct::FIR_Direct()
 {
 }
 
-Convolver::~Convolver()
+void FIR_Direct::prepare(const float* h, uint32_t h_len)
 {
-    if (IR)
+    IR_len = h_len;
+
+    taps.resize(IR_len);
+    for (uint32_t i = 0; i < IR_len; ++i)
+        taps[i] = h[IR_len - 1u - i];
+
+    history.assign(2u * IR_len, 0.0f);
+    pos = 0;
+}
+
+void FIR_Direct::setNormFactor(float value)
+{
+    normFactor = value;
+}
+
+void FIR_Direct::clearBuffers()
+{
+    std::fill(history.begin(), history.end(), 0.0f);
+    pos = 0;
+}
+
+float FIR_Direct::process(float input)
+{
+    if (IR_len == 0)
+        return 0.0f;
+
+    history[pos] = input;
+    history[pos + IR_len] = input;
+    pos = (pos + 1u == IR_len) ? 0u : pos + 1u;
+
+    // history[pos .. pos + IR_len - 1] = oldest .. newest sample
+    float out = dotProduct(taps.data(), &history[pos], IR_len);
+
+    if (normalize)
+        out *= normFactor;
+
+    return out;
+}
+
+
+namespace
+{
+    // Kernel speeds of this machine, in seconds per unit of work. Measured once per process.
+    struct KernelSpeeds
+    {
+        double directTap = 0.0; // one tap of FIR_Direct
+        double fftPoint = 0.0; // one point * log2(N) of FFT_process
+        double macBin = 0.0; // one complex multiply-accumulate of FIR_FFT_OLS
+    };
+
+    double secondsSince(juce::int64 startTicks)
+    {
+        return juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+    }
+
+    KernelSpeeds measureKernelSpeeds()
+    {
+        KernelSpeeds speeds;
+        volatile float sink = 0.0f;
+
+        const uint32_t numTaps = 256u;
+        const uint32_t numSamples = 8192u;
+        std::vector<float> h(numTaps, 0.01f);
+
+        FIR_Direct direct;
+        direct.prepare(h.data(), numTaps);
+
+        auto start = juce::Time::getHighResolutionTicks();
+        for (uint32_t i = 0; i < numSamples; ++i)
+            sink = sink + direct.process((float)(i & 7u));
+        speeds.directTap = secondsSince(start) / ((double)numSamples * numTaps);
+
+        const uint32_t fftSize = 1024u;
+        const uint32_t numFFTs = 64u;
+        std::vector<float> re(fftSize), im(fftSize);
+        FFT fft;
+        fft.prepare(fftSize);
+
+        start = juce::Time::getHighResolutionTicks();
+        for (uint32_t i = 0; i < numFFTs; ++i)
+        {
+            std::fill(re.begin(), re.end(), (float)i);
+            std::fill(im.begin(), im.end(), 0.0f);
+            fft.FFT_process(re.data(), im.data(), fftSize);
+            sink = sink + re[1];
+        }
+        speeds.fftPoint = secondsSince(start) / ((double)numFFTs * fftSize * 10.0);
+
+        const uint32_t numMacs = 256u;
+        std::vector<float> accRe(fftSize, 0.0f), accIm(fftSize, 0.0f);
+
+        start = juce::Time::getHighResolutionTicks();
+        for (uint32_t i = 0; i < numMacs; ++i)
+        {
+            for (uint32_t k = 0; k < fftSize; ++k)
+            {
+                accRe[k] += re[k] * h[k & 255u] - im[k] * h[(k + 1u) & 255u];
+                accIm[k] += re[k] * h[(k + 1u) & 255u] + im[k] * h[k & 255u];
+            }
+        }
+        sink = sink + accRe[3] + accIm[5];
+        speeds.macBin = secondsSince(start) / ((double)numMacs * fftSize);
+
+        return speeds;
+    }
+
+    const KernelSpeeds& getKernelSpeeds()
     {
-        delete[] IR;
+        static const KernelSpeeds speeds = measureKernelSpeeds();
+        return speeds;
     }
 }
 
+
+Convolver::Convolver()
+{
+}
+
+Convolver::~Convolver()
+{
+    fir_fft_ols.releasePartitions();
+    irStore->trim();
+}
+
 float Convolver::process(float input)
 {
     if (IR_loaded == true && reinitFlag == false)
     {
         if (enable == true)
         {
-            return fir_fft_ols.process(input);
+            if (decimation > 1u)
+                return processDecimated(input);
+
+            return processEngine(input);
         }
         else
         {
@@ -261,41 +558,183 @@ float Convolver::process(float input)
     }
 }
 
-void Convolver::loadIR(const juce::File& file)
+float Convolver::processEngine(float input)
 {
-    IR_loaded = false;
-    IR_loader.loadWavFile(file);
+    if (engine == Engine::Direct)
+        return fir_direct.process(input);
 
-    uint32_t IR_length;
+    return fir_fft_ols.process(input);
+}
 
-    if ((IR_loader.fileSampleRate != sampleRate) && (sampleRate != 0))
+// Cost model: estimated time per output sample of each engine, from the IR
+// length, partition size and kernel speeds measured on this machine.
+Convolver::Engine Convolver::chooseEngine() const
+{
+    const KernelSpeeds& speeds = getKernelSpeeds();
+
+    const double fftSize = (double)fir_fft_ols.getFFTSize();
+    const double hop = 0.5 * fftSize;
+    const double macs = fir_fft_ols.getNumSegments() * fftSize * (1.0 - fir_fft_ols.getSkipRatio());
+
+    double directCost = IR_len * speeds.directTap;
+    double fftCost = (2.0 * speeds.fftPoint * fftSize * std::log2(fftSize) + macs * speeds.macBin) / hop;
+
+    DBG("direct= " << directCost * 1e9 << " ns, FFT= " << fftCost * 1e9 << " ns per sample");
+
+    return (directCost <= fftCost) ? Engine::Direct : Engine::UniformFFT;
+}
+
+// Band limit and decimate the input, convolve at the lower rate and interpolate back.
+// Output lags by one group of `decimation` samples plus the half-band filters delay.
+float Convolver::processDecimated(float input)
+{
+    decimIn[decimPos] = input;
+    float out = decimOut[decimPos];
+
+    if (++decimPos == decimation)
     {
-        if (IR)
+        decimPos = 0;
+
+        // the IR resampled to convRate keeps its sample values, so its tap sum is
+        // 1 / decimation of the full rate one; normalized output is level matched already
+        const float gain = fir_fft_ols.normalize ? 1.0f : (float)decimation;
+
+        float y;
+
+        if (decimation == 2u)
         {
-            delete[] IR;
+            y = gain * processEngine(decimators[0].decimate(decimIn[0], decimIn[1]));
+            interpolators[0].interpolate(y, decimOut[0], decimOut[1]);
         }
-        IR = nullptr;
+        else
+        {
+            float a = decimators[0].decimate(decimIn[0], decimIn[1]);
+            float b = decimators[0].decimate(decimIn[2], decimIn[3]);
+            y = gain * processEngine(decimators[1].decimate(a, b));
 
-        // resampling the IR
-        rs.resample(IR_loader.fileSampleRate, sampleRate, IR_loader.audioBuffer.getReadPointer(0), IR_loader.audioBuffer.getNumSamples(), IR, IR_length);
+            interpolators[1].interpolate(y, a, b);
+            interpolators[0].interpolate(a, decimOut[0], decimOut[1]);
+            interpolators[0].interpolate(b, decimOut[2], decimOut[3]);
+        }
+    }
+
+    return out;
+}
+
+void Convolver::loadIR(const juce::File& file)
+{
+    IR_loaded = false;
 
-        this->IR_ptr = IR;
-        this->IR_len = IR_length;
+    // the header is enough for the store key, the samples are decoded only on a miss
+    if (!IR_loader.readInfo(file) || IR_loader.fileLength == 0)
+        return;
+
+    const uint64_t fileHash = IRStore::hashFile(file);
+    if (fileHash == 0)
+        return;
+
+    // partition size tuned for this IR length; the first load of a length uses the largest
+    // partition in the budget while the planner benchmarks in the background
+    uint32_t fileLength = IR_loader.fileLength;
+    bool needsResampling = (IR_loader.fileSampleRate != convRate) && (IR_loader.fileSampleRate != 0) && (convRate != 0);
+    uint32_t expectedLength = needsResampling
+        ? Resampler::getResampledLength(IR_loader.fileSampleRate, static_cast<uint32_t>(convRate), fileLength)
+        : fileLength;
+
+    // both bounds are in host samples, a partition at the convolution rate lasts `decimation` of them
+    uint32_t maxPartition = (latencyBudget > 0)
+        ? latencyBudget / decimation
+        : fir_fft_ols.fft.calculateFFTWindow(static_cast<uint32_t>(blockLength)) / 2u / decimation;
+
+    uint32_t plannedFFTSize = planner->plan(expectedLength, maxPartition);
+    if (plannedFFTSize != fftSizeN)
+    {
+        fftSizeN = plannedFFTSize;
+        fir_fft_ols.setFFTSize(fftSizeN);
+    }
+
+    // other instances could already prepare this IR with the same settings
+    IRStore::Key key{ fileHash, static_cast<uint32_t>(convRate), fftSizeN / 2u };
+
+    if (auto shared = irStore->find(key))
+    {
+        fir_fft_ols.setPartitions(shared);
+        fir_fft_ols.setNormFactor(shared->normFactor);
+        fir_fft_ols.clearBuffers();
+        this->IR_len = shared->IR_len;
+
+        engine = chooseEngine();
+        if (engine == Engine::Direct)
+            fir_direct.prepare(shared->IR.data(), shared->IR_len);
+        fir_direct.setNormFactor(shared->normFactor);
+
+        irStore->trim();
+
+        IR_loaded = true;
+        return;
+    }
+
+    // a failed read keeps the previous buffer in the loader, it must not be stored under this file
+    if (!IR_loader.loadWavFile(file) || (uint32_t)IR_loader.audioBuffer.getNumSamples() != fileLength)
+        return;
+
+    // the IR goes straight into the (aligned) storage of the new partition set
+    auto partitions = std::make_shared<IRPartitions>();
+    partitions->IR.resize(expectedLength);
+
+    if (needsResampling)
+    {
+        uint32_t written = Resampler::resampleInto(IR_loader.fileSampleRate, static_cast<uint32_t>(convRate),
+            IR_loader.audioBuffer.getReadPointer(0), fileLength, partitions->IR.data(), expectedLength);
+
+        if (written == 0)
+            return;
     }
     else
     {
-        this->IR_ptr = (float*)IR_loader.audioBuffer.getReadPointer(0);
-        this->IR_len = IR_loader.audioBuffer.getNumSamples();
+        std::memcpy(partitions->IR.data(), IR_loader.audioBuffer.getReadPointer(0), fileLength * sizeof(float));
     }
 
-    fir_fft_ols.prepare(this->IR_ptr, this->IR_len);
+    fir_fft_ols.buildSpectra(*partitions);
+    fir_fft_ols.setPartitions(partitions);
+
+    this->IR_ptr = partitions->IR.data();
+    this->IR_len = partitions->IR_len;
+
+    engine = chooseEngine();
+    if (engine == Engine::Direct)
+        fir_direct.prepare(this->IR_ptr, this->IR_len);
 
     normalize();
     normalize();
 
+    // publish the prepared spectra (with its norm factor) for other instances
+    partitions->normFactor = fir_fft_ols.getNormFactor();
+    irStore->insert(key, partitions);
+
+    DBG("skip ratio= " << fir_fft_ols.getSkipRatio());
+
     IR_loaded = true;
 }
 
+uint32_t Convolver::getLatency() const
+{
+    if (!IR_loaded)
+        return 0;
+
+    // output block of the OLS is available once its last input sample is in
+    uint32_t latency = (engine == Engine::UniformFFT) ? fir_fft_ols.getFFTSize() / 2u - 1u : 0u;
+    latency *= decimation;
+
+    // half-band pairs (at rate / 2 and rate / 4) and one group of `decimation` samples
+    if (decimation >= 2u)
+        latency += 2u * decimators[0].getLatency() + decimation;
+    if (decimation == 4u)
+        latency += 4u * decimators[1].getLatency();
+
+    return latency;
+}
+
 void Convolver::init(double sampleRate, int blockLength)
 {
     reinitFlag = true;
@@ -304,6 +743,26 @@ void Convolver::init(double sampleRate, int blockLength)
     this->blockLength = blockLength;
     this->fftSizeN = fir_fft_ols.fft.calculateFFTWindow(static_cast<uint32_t>(this->blockLength));
 
+    // partition size stays the same in samples, so at the lower rate both
+    // the number of partitions and the number of processed samples drop
+    decimation = 1u;
+    if (decimationEnabled)
+    {
+        while (decimation < 4u && sampleRate / (2.0 * decimation) >= minDecimatedRate)
+            decimation *= 2u;
+    }
+
+    convRate = sampleRate / decimation;
+
+    for (uint32_t i = 0; i < 2u; ++i)
+    {
+        decimators[i].reset();
+        interpolators[i].reset();
+    }
+    std::fill(std::begin(decimIn), std::end(decimIn), 0.0f);
+    std::fill(std::begin(decimOut), std::end(decimOut), 0.0f);
+    decimPos = 0;
+
     fir_fft_ols.setFFTSize(this->fftSizeN);
 
     reinitFlag = false;
@@ -317,6 +776,38 @@ void Convolver::setEnable(bool enable)
 void Convolver::setNormalize(bool enable)
 {
     fir_fft_ols.normalize = enable;
+    fir_direct.normalize = enable;
+}
+
+Convolver::Engine Convolver::getEngine() const
+{
+    return engine;
+}
+
+void Convolver::setDecimation(bool enable, double minRate)
+{
+    decimationEnabled = enable;
+    minDecimatedRate = minRate;
+}
+
+uint32_t Convolver::getDecimationFactor() const
+{
+    return decimation;
+}
+
+void Convolver::setLatencyBudget(uint32_t samples)
+{
+    latencyBudget = samples;
+}
+
+void Convolver::setSparseErrorBound(float bound)
+{
+    fir_fft_ols.setSparseErrorBound(bound);
+}
+
+float Convolver::getSkipRatio() const
+{
+    return fir_fft_ols.getSkipRatio();
 }
 
 void Convolver::normalize()
@@ -332,10 +823,11 @@ void Convolver::normalize()
 
     // clear old memory with zeros
     fir_fft_ols.clearBuffers();
+    fir_direct.clearBuffers();
 
     for (uint32_t i = 0u; i < CHIRP_LENGTH; i++)
     {
-        signal = fir_fft_ols.process(chirp[i]);
+        signal = processEngine(chirp[i]);
 
         absSignal = std::abs(signal);
 
@@ -348,7 +840,7 @@ void Convolver::normalize()
     // tail of signal with zeros
     for (uint32_t i = 0u; i < IR_len; i++)
     {
-        signal = fir_fft_ols.process(0.0f);
+        signal = processEngine(0.0f);
 
         absSignal = std::abs(signal);
 
@@ -363,9 +855,11 @@ void Convolver::normalize()
     DBG("max= " << max << ", factor= " << factor);
 
     fir_fft_ols.setNormFactor(factor);
+    fir_direct.setNormFactor(factor);
 
     // clear buffers
     fir_fft_ols.clearBuffers();
+    fir_direct.clearBuffers();
 
     setNormalize(actualNormState);
 
@@ -14,18 +14,25 @@
 #include <cstring>
 #include "FFT.h"
 #include "Resampler.h"
+#include "IRStore.h"
+#include "HalfBand.h"
+#include "VectorOps.h"
+#include "ConvolutionPlanner.h"
 
 
 class AudioLoader
 {
 public:
     AudioLoader();
+    // header only: fileSampleRate and fileLength, the samples are not decoded
+    bool readInfo(const juce::File& file);
     bool loadWavFile(const juce::File& file);
     juce::AudioBuffer<float>& getAudioBuffer();
 
     juce::AudioBuffer<float> audioBuffer;
 
     uint32_t fileSampleRate = 0.0;
+    uint32_t fileLength = 0;
 private:
     juce::AudioFormatManager formatManager;
 
@@ -39,17 +46,32 @@ public:
     ~FIR_FFT_OLS();
     void setFFTSize(uint32_t fftSize);
     void prepare(const float* h, uint32_t h_len);
+    std::shared_ptr<IRPartitions> createPartitions(const float* h, uint32_t h_len);
+    void buildSpectra(IRPartitions& p);
+    void setPartitions(std::shared_ptr<const IRPartitions> partitions);
+    void releasePartitions();
     float process(float input);
     void setNormFactor(float value);
+    float getNormFactor() const;
     void clearBuffers();
 
+    // Max energy (relative to the whole IR) of the partitions and high bins
+    // that can be left out of the MAC loop. 0 = exact convolution.
+    void setSparseErrorBound(float bound);
+    float getSkipRatio() const;
+
+    uint32_t getFFTSize() const;
+    uint32_t getNumSegments() const;
+
     bool normalize = false;
     FFT fft;
 
 private:
 
-    std::vector<std::vector<float>> h_fft_Re;
-    std::vector<std::vector<float>> h_fft_Im;
+    void classifyPartitions();
+
+    std::shared_ptr<const IRPartitions> partitions; // IR spectra, shared between instances
+    std::vector<uint32_t> activeBins; // per partition: bins [0, n) and their mirror are used, 0 = skipped
     std::vector<float> inputBufferRe; // Input samples buffer
     std::vector<float> inputBufferIm;
     std::vector<float> inputBuffer;
@@ -68,11 +90,35 @@ private:
     uint32_t IR_len = 0;
     uint32_t numSegments = 0;
     float normFactor = 1.0f;
+    float sparseErrorBound = 0.0f;
+    float skipRatio = 0.0f;
+};
+
+// Time domain FIR for short IRs: no FFT round trip and no added latency
+class FIR_Direct
+{
+public:
+    FIR_Direct();
+    void prepare(const float* h, uint32_t h_len);
+    float process(float input);
+    void setNormFactor(float value);
+    void clearBuffers();
+
+    bool normalize = false;
+
+private:
+    std::vector<float> taps; // reversed IR, the dot product runs from the oldest sample
+    std::vector<float> history; // every sample written twice, window never wraps
+    uint32_t pos = 0;
+    uint32_t IR_len = 0;
+    float normFactor = 1.0f;
 };
 
 class Convolver
 {
 public:
+    enum class Engine { Direct, UniformFFT };
+
     Convolver();
     ~Convolver();
     void init(double sampleRate, int blockLength);
@@ -80,6 +126,17 @@ public:
     void loadIR(const juce::File& file);
     void setEnable(bool enable);
     void setNormalize(bool enable);
+    void setSparseErrorBound(float bound);
+    float getSkipRatio() const;
+    // Convolve at sampleRate / 2 or / 4 (staying at or above minRate), takes effect on next init()
+    void setDecimation(bool enable, double minRate = 44100.0);
+    uint32_t getDecimationFactor() const;
+    // Max cab latency in host samples; partition size is tuned within it.
+    // 0 = one partition per half of the host block (as before)
+    void setLatencyBudget(uint32_t samples);
+    // Delay of the loaded cab in host samples (FFT hop, half-band filters, decimation grouping)
+    uint32_t getLatency() const;
+    Engine getEngine() const;
     void normalize();
 
     bool IR_loaded = false;
@@ -87,15 +144,33 @@ public:
     bool normPending = false;
 
 private:
+    float processEngine(float input);
+    float processDecimated(float input);
+    Engine chooseEngine() const;
+
     AudioLoader IR_loader;
     FIR_FFT_OLS fir_fft_ols;
-    Resampler rs;
-    float* IR = nullptr;
+    FIR_Direct fir_direct;
+    Engine engine = Engine::UniformFFT;
+    juce::SharedResourcePointer<IRStore> irStore;
+    juce::SharedResourcePointer<ConvolutionPlanner> planner;
     double sampleRate = 48000.0;
+    double convRate = 48000.0; // rate of the convolution (sampleRate / decimation)
     int blockLength = 64;
     uint32_t fftSizeN;
+    uint32_t latencyBudget = 0;
     bool enable = false;
     bool reinitFlag = false;
 
+    // decimated mode: half-band stages, [0] runs at the host rate
+    bool decimationEnabled = false;
+    double minDecimatedRate = 44100.0;
+    uint32_t decimation = 1;
+    HalfBandFilter decimators[2];
+    HalfBandFilter interpolators[2];
+    float decimIn[4] = {};
+    float decimOut[4] = {};
+    uint32_t decimPos = 0;
+
     const float* IR_ptr = nullptr;
 };
@@ -0,0 +1,199 @@
+/*
+  ==============================================================================
+
+    ConvolutionPlanner.cpp
+    Created: 19 Oct 2026 4:05:52pm
+    Author:  dkuzn
+
+  ==============================================================================
+*/
+
+#include "ConvolutionPlanner.h"
+#include "CabSim.h"
+#include <algorithm>
+#include <vector>
+
+#define PLANNER_MIN_PARTITION 16u
+
+
+ConvolutionPlanner::ConvolutionPlanner()
+{
+}
+
+ConvolutionPlanner::~ConvolutionPlanner()
+{
+    {
+        std::lock_guard<std::mutex> guard(queueLock);
+        quit = true;
+    }
+    queueWake.notify_one();
+
+    if (worker.joinable())
+        worker.join();
+}
+
+juce::File ConvolutionPlanner::getWisdomFile()
+{
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+        .getChildFile("dkAmp")
+        .getChildFile("wisdom.xml");
+}
+
+uint32_t ConvolutionPlanner::plan(uint32_t IR_len, uint32_t maxPartitionSize)
+{
+    // only powers of 2 are supported by the FFT
+    uint32_t maxPartition = 1;
+    while (maxPartition * 2u <= maxPartitionSize)
+        maxPartition *= 2u;
+
+    if (maxPartition <= PLANNER_MIN_PARTITION || IR_len == 0)
+        return 2u * maxPartition;
+
+    // plans for IRs of similar length are the same
+    uint32_t lengthBucket = 1;
+    while (lengthBucket < IR_len)
+        lengthBucket *= 2u;
+
+    const Key key = std::make_pair(lengthBucket, maxPartition);
+
+    {
+        const juce::ScopedLock sl(lock);
+
+        if (!wisdomLoaded)
+            loadWisdom();
+
+        auto it = wisdom.find(key);
+        if (it != wisdom.end())
+            return 2u * it->second;
+    }
+
+    // benchmarking all candidates takes a while, the next load of this length gets the result
+    {
+        std::lock_guard<std::mutex> guard(queueLock);
+
+        if (std::find(queue.begin(), queue.end(), key) == queue.end())
+            queue.push_back(key);
+
+        if (!worker.joinable())
+            worker = std::thread(&ConvolutionPlanner::benchmarkThread, this);
+    }
+    queueWake.notify_one();
+
+    return 2u * maxPartition;
+}
+
+void ConvolutionPlanner::benchmarkThread()
+{
+    std::unique_lock<std::mutex> guard(queueLock);
+
+    for (;;)
+    {
+        queueWake.wait(guard, [this] { return !queue.empty() || quit; });
+        if (quit)
+            break;
+
+        const Key key = queue.front();
+        guard.unlock();
+
+        uint32_t bestPartition = key.second;
+        double bestTime = 0.0;
+
+        for (uint32_t partition = PLANNER_MIN_PARTITION; partition <= key.second; partition *= 2u)
+        {
+            double time = benchmark(2u * partition, key.first);
+
+            DBG("partition " << (int)partition << ": " << time * 1e9 << " ns per sample");
+
+            if (partition == PLANNER_MIN_PARTITION || time < bestTime)
+            {
+                bestTime = time;
+                bestPartition = partition;
+            }
+        }
+
+        {
+            const juce::ScopedLock sl(lock);
+            wisdom[key] = bestPartition;
+            saveWisdom();
+        }
+
+        guard.lock();
+        queue.erase(queue.begin());
+    }
+}
+
+// Time per output sample of FIR_FFT_OLS with given FFT size (best of three runs)
+double ConvolutionPlanner::benchmark(uint32_t fftSize, uint32_t IR_len) const
+{
+    std::vector<float> h(IR_len);
+    uint32_t seed = 12345u;
+    for (auto& sample : h)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        sample = (float)(seed >> 8) / 16777216.0f - 0.5f;
+    }
+
+    FIR_FFT_OLS fir;
+    fir.setFFTSize(fftSize);
+    fir.setSparseErrorBound(0.0f);
+    fir.prepare(h.data(), IR_len);
+
+    const uint32_t numSamples = std::max(8u * fftSize, 8192u);
+    volatile float sink = 0.0f;
+    double best = 0.0;
+
+    for (int run = 0; run < 3; ++run)
+    {
+        auto start = juce::Time::getHighResolutionTicks();
+
+        for (uint32_t i = 0; i < numSamples; ++i)
+            sink = sink + fir.process((float)(i & 15u));
+
+        double time = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+
+        if (run == 0 || time < best)
+            best = time;
+    }
+
+    return best / numSamples;
+}
+
+void ConvolutionPlanner::loadWisdom()
+{
+    wisdomLoaded = true;
+
+    auto file = getWisdomFile();
+    if (!file.existsAsFile())
+        return;
+
+    std::unique_ptr<juce::XmlElement> xml = juce::parseXML(file);
+    if (xml == nullptr || !xml->hasTagName("WISDOM"))
+        return;
+
+    for (auto* planXml : xml->getChildWithTagNameIterator("PLAN"))
+    {
+        uint32_t length = (uint32_t)planXml->getIntAttribute("irLength");
+        uint32_t maxPartition = (uint32_t)planXml->getIntAttribute("maxPartition");
+        uint32_t partition = (uint32_t)planXml->getIntAttribute("partition");
+
+        if (length > 0 && partition > 0 && partition <= maxPartition)
+            wisdom[std::make_pair(length, maxPartition)] = partition;
+    }
+}
+
+void ConvolutionPlanner::saveWisdom() const
+{
+    juce::XmlElement xml("WISDOM");
+
+    for (const auto& item : wisdom)
+    {
+        auto* planXml = xml.createNewChildElement("PLAN");
+        planXml->setAttribute("irLength", (int)item.first.first);
+        planXml->setAttribute("maxPartition", (int)item.first.second);
+        planXml->setAttribute("partition", (int)item.second);
+    }
+
+    auto file = getWisdomFile();
+    file.getParentDirectory().createDirectory();
+    xml.writeTo(file);
+}
@@ -0,0 +1,59 @@
+/*
+  ==============================================================================
+
+    ConvolutionPlanner.h
+    Created: 19 Oct 2026 4:05:52pm
+    Author:  dkuzn
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+
+// Picks the fastest partition size for FIR_FFT_OLS on this machine, like the
+// FFTW planner: candidate sizes within the latency budget are benchmarked once
+// and the winner is saved to a wisdom file, so later sessions skip the benchmark.
+// The benchmark runs on a background thread, until it is done plan() returns
+// the largest partition within the budget.
+class ConvolutionPlanner
+{
+public:
+    ConvolutionPlanner();
+    ~ConvolutionPlanner();
+
+    // Returns the FFT size (2 * partition size) for an IR of IR_len samples,
+    // with partition size not larger than maxPartitionSize. Never blocks on a benchmark.
+    uint32_t plan(uint32_t IR_len, uint32_t maxPartitionSize);
+
+    static juce::File getWisdomFile();
+
+private:
+    using Key = std::pair<uint32_t, uint32_t>; // (IR length bucket, max partition size)
+
+    double benchmark(uint32_t fftSize, uint32_t IR_len) const;
+    void benchmarkThread();
+    void loadWisdom();
+    void saveWisdom() const;
+
+    juce::CriticalSection lock;
+    // (IR length bucket, max partition size) -> partition size
+    std::map<Key, uint32_t> wisdom;
+    bool wisdomLoaded = false;
+
+    // keys waiting for a benchmark, worker started on the first one
+    std::thread worker;
+    std::mutex queueLock;
+    std::condition_variable queueWake;
+    std::vector<Key> queue;
+    bool quit = false;
+};
@@ -9,21 +9,576 @@
 */
 
 #include "DiodeClipper.h"
+#include "FastMath.h"
 #include <cmath>
 #include <algorithm>
 
+namespace
+{
+    // table grid: Vin in [-tableRange, tableRange], outside it linear asymptotes;
+    // odd size -> step is exactly 1/64 and Vin = 0 is a grid point
+    constexpr double tableRange = 32.0;
+    constexpr uint32_t tableSize = 4097u;
+
+    // below this input difference the ADAA divided differences are ill-conditioned
+    constexpr double adaaTolerance = 1e-4;
+
+    // integrals of the cubic Hermite basis over [0, t] (G) and of those again (K),
+    // coefficients for y0, m0, y1, m1
+    inline double hermiteG(double t, double y0, double m0, double y1, double m1)
+    {
+        double t2 = t * t;
+        double t3 = t2 * t;
+        double t4 = t3 * t;
+
+        return (t - t3 + 0.5 * t4) * y0
+            + (0.5 * t2 - (2.0 / 3.0) * t3 + 0.25 * t4) * m0
+            + (t3 - 0.5 * t4) * y1
+            + (0.25 * t4 - (1.0 / 3.0) * t3) * m1;
+    }
+
+    inline double hermiteK(double t, double y0, double m0, double y1, double m1)
+    {
+        double t2 = t * t;
+        double t3 = t2 * t;
+        double t4 = t3 * t;
+        double t5 = t4 * t;
+
+        return (0.5 * t2 - 0.25 * t4 + 0.1 * t5) * y0
+            + (t3 / 6.0 - t4 / 6.0 + 0.05 * t5) * m0
+            + (0.25 * t4 - 0.1 * t5) * y1
+            + (0.05 * t5 - t4 / 12.0) * m1;
+    }
+
+    // Vin = V + 2*R*Is*sinh(V/nVt) is monotonic in V, solved with Newton
+    // safeguarded by bisection (V lies between 0 and Vin).
+    // Start point nVt*asinh(Vin/(2*R*Is)) is on the convex side of the root,
+    // so Newton converges monotonically from it.
+    double solveNodeExact(double Vin, double R, double Is, double nVt)
+    {
+        double lo = std::min(0.0, Vin);
+        double hi = std::max(0.0, Vin);
+        double V = std::clamp(nVt * std::asinh(Vin / (2.0 * R * Is)), lo, hi);
+
+        for (int i = 0; i < 200; ++i)
+        {
+            double f = V + 2.0 * R * Is * std::sinh(V / nVt) - Vin;
+            double df = 1.0 + 2.0 * R * Is * std::cosh(V / nVt) / nVt;
+
+            if (f > 0.0) hi = V; else lo = V;
+
+            double next = V - f / df;
+            if (!(next > lo && next < hi))
+                next = 0.5 * (lo + hi);
+
+            if (std::fabs(next - V) < 1e-15 + 1e-13 * std::fabs(V))
+                return next;
+
+            V = next;
+        }
+
+        return V;
+    }
+}
+
 DiodeClipper::DiodeClipper(float R, float Is, float nVt, int maxIter, float tol)
     : R_(R), Is_(Is), nVt_(nVt), maxIter_(maxIter), tol_(tol)
 {
 }
 
-void DiodeClipper::setSeriesResistance(float R) { R_ = R; }
-void DiodeClipper::setSaturationCurrent(float Is) { Is_ = Is; }
-void DiodeClipper::setNVt(float nVt) { nVt_ = nVt; }
+DiodeClipper::~DiodeClipper()
+{
+}
+
+void DiodeClipper::setSeriesResistance(float R) { R_ = R; requestTableRebuild(); }
+void DiodeClipper::setSaturationCurrent(float Is) { Is_ = Is; requestTableRebuild(); }
+void DiodeClipper::setNVt(float nVt) { nVt_ = nVt; requestTableRebuild(); }
+
+void DiodeClipper::setMode(Mode mode)
+{
+    mode_ = mode;
+    adaaReset = true;
+
+    if (mode != Mode::Exact && !isTableReady())
+        requestTableRebuild();
+}
+
+bool DiodeClipper::isTableReady() const
+{
+    return tables.isReady();
+}
 
 float DiodeClipper::process(float input)
 {
-    return solveNode(input);
+    if (mode_ != Mode::Exact)
+    {
+        if (const Table* t = acquireTable())
+            return (mode_ == Mode::Table) ? t->lookup(input) : processAdaa(*t, input);
+    }
+
+    float output = solveNode(input, pendingStats);
+
+    if (pendingStats.samples >= statsFlushInterval)
+        publishStats();
+
+    return output;
+}
+
+DiodeClipper::Stats DiodeClipper::getStats() const
+{
+    Stats stats;
+    stats.samples = statSamples.load(std::memory_order_relaxed);
+    stats.iterations = statIterations.load(std::memory_order_relaxed);
+    stats.maxIterHits = statMaxIterHits.load(std::memory_order_relaxed);
+    stats.fallbacks = statFallbacks.load(std::memory_order_relaxed);
+
+    for (int i = 0; i < kHistogramBins; ++i)
+        stats.histogram[i] = statHistogram[i].load(std::memory_order_relaxed);
+
+    for (int i = 0; i < kLevelBins; ++i)
+    {
+        stats.levelSamples[i] = statLevelSamples[i].load(std::memory_order_relaxed);
+        stats.levelIterations[i] = statLevelIterations[i].load(std::memory_order_relaxed);
+    }
+
+    return stats;
+}
+
+void DiodeClipper::resetStats()
+{
+    statSamples.store(0);
+    statIterations.store(0);
+    statMaxIterHits.store(0);
+    statFallbacks.store(0);
+
+    for (auto& c : statHistogram)
+        c.store(0);
+
+    for (int i = 0; i < kLevelBins; ++i)
+    {
+        statLevelSamples[i].store(0);
+        statLevelIterations[i].store(0);
+    }
+}
+
+void DiodeClipper::countSolve(Stats& stats, float Vin, int iterations, bool unconverged, bool fallback)
+{
+    // octave of |Vin|: frexp gives |Vin| in [2^(e-1), 2^e); it also gives e = 0
+    // for 0, so silence (and NaN) goes to the lowest bin before frexp is asked
+    const float a = std::fabs(Vin);
+    int level = 0;
+
+    if (a >= 16.0f)
+        level = kLevelBins - 1;
+    else if (a >= 0.0625f)
+    {
+        int e = 0;
+        std::frexp(a, &e);
+        level = e + 4;
+    }
+
+    stats.samples++;
+    stats.iterations += (uint64_t)iterations;
+    stats.maxIterHits += unconverged ? 1u : 0u;
+    stats.fallbacks += fallback ? 1u : 0u;
+    stats.histogram[std::min(iterations, kHistogramBins - 1)]++;
+    stats.levelSamples[level]++;
+    stats.levelIterations[level] += (uint64_t)iterations;
+}
+
+void DiodeClipper::publishStats()
+{
+    if (pendingStats.samples == 0)
+        return;
+
+    // plain fetch_add per counter: a reader may see one block half published,
+    // which is fine for statistics
+    statSamples.fetch_add(pendingStats.samples, std::memory_order_relaxed);
+    statIterations.fetch_add(pendingStats.iterations, std::memory_order_relaxed);
+    statMaxIterHits.fetch_add(pendingStats.maxIterHits, std::memory_order_relaxed);
+    statFallbacks.fetch_add(pendingStats.fallbacks, std::memory_order_relaxed);
+
+    for (int i = 0; i < kHistogramBins; ++i)
+    {
+        if (pendingStats.histogram[i] != 0)
+            statHistogram[i].fetch_add(pendingStats.histogram[i], std::memory_order_relaxed);
+    }
+
+    for (int i = 0; i < kLevelBins; ++i)
+    {
+        if (pendingStats.levelSamples[i] != 0)
+        {
+            statLevelSamples[i].fetch_add(pendingStats.levelSamples[i], std::memory_order_relaxed);
+            statLevelIterations[i].fetch_add(pendingStats.levelIterations[i], std::memory_order_relaxed);
+        }
+    }
+
+    pendingStats = Stats();
+}
+
+// y = (F1(x) - F1(x1)) / (x - x1) for ADAA1, for ADAA2 the same difference of
+// F2 divided twice; near equal inputs the limits of those quotients are used
+float DiodeClipper::processAdaa(const Table& t, float input)
+{
+    const double x = input;
+
+    if (adaaReset)
+    {
+        adaaX1 = x;
+        adaaX2 = x;
+        adaaF1 = t.antiderivative1(x);
+        adaaF2 = t.antiderivative2(x);
+        adaaD = adaaF1;
+        adaaReset = false;
+    }
+
+    double y;
+
+    if (mode_ == Mode::Adaa1)
+    {
+        double F1 = t.antiderivative1(x);
+        double dx = x - adaaX1;
+
+        y = (std::fabs(dx) > adaaTolerance)
+            ? (F1 - adaaF1) / dx
+            : t.lookup((float)(0.5 * (x + adaaX1)));
+
+        adaaF1 = F1;
+    }
+    else
+    {
+        double F2 = t.antiderivative2(x);
+        double dx = x - adaaX1;
+
+        double D = (std::fabs(dx) > adaaTolerance)
+            ? (F2 - adaaF2) / dx
+            : t.antiderivative1(0.5 * (x + adaaX1));
+
+        double dx2 = x - adaaX2;
+
+        if (std::fabs(dx2) > adaaTolerance)
+        {
+            y = 2.0 * (D - adaaD) / dx2;
+        }
+        else
+        {
+            double xBar = 0.5 * (x + adaaX2);
+            double delta = xBar - adaaX1;
+
+            y = (std::fabs(delta) > adaaTolerance)
+                ? 2.0 / delta * (t.antiderivative1(xBar) + (adaaF2 - t.antiderivative2(xBar)) / delta)
+                : t.lookup((float)(0.5 * (xBar + adaaX1)));
+        }
+
+        adaaF2 = F2;
+        adaaD = D;
+    }
+
+    adaaX2 = adaaX1;
+    adaaX1 = x;
+
+    return (float)y;
+}
+
+void DiodeClipper::processBlock(float* samples, int numSamples)
+{
+    if (mode_ != Mode::Exact)
+    {
+        if (const Table* t = acquireTable())
+        {
+            if (mode_ == Mode::Table)
+            {
+                for (int i = 0; i < numSamples; ++i)
+                    samples[i] = t->lookup(samples[i]);
+            }
+            else
+            {
+                for (int i = 0; i < numSamples; ++i)
+                    samples[i] = processAdaa(*t, samples[i]);
+            }
+
+            if (numSamples > 0)
+                lastOutput_ = samples[numSamples - 1];
+            return;
+        }
+    }
+
+    if (R_ <= 0.0f || Is_ <= 0.0f || nVt_ <= 0.0f)
+        return;
+
+    float Vin[kLanes];
+    float V[kLanes];
+    float iterations[kLanes];
+    float unconverged[kLanes];
+
+    for (int start = 0; start < numSamples; start += kLanes)
+    {
+        const int count = std::min(kLanes, numSamples - start);
+
+        // tail lanes repeat the last sample, their results are dropped
+        for (int l = 0; l < kLanes; ++l)
+        {
+            Vin[l] = samples[start + std::min(l, count - 1)];
+            V[l] = lastOutput_; // warm start
+        }
+
+        solveLanes(V, Vin, iterations, unconverged);
+
+        for (int l = 0; l < count; ++l)
+        {
+            float y = V[l];
+            bool fallback = !std::isfinite(y);
+
+            // If Newton diverged to NaN or inf, fallback to a smooth clipper
+            if (fallback)
+            {
+                float gain = 1.0f / (10.0f * nVt_);
+                y = fastTanh(Vin[l] * gain) / gain;
+            }
+
+            countSolve(pendingStats, Vin[l], (int)iterations[l], unconverged[l] != 0.0f, fallback);
+            samples[start + l] = y;
+        }
+
+        lastOutput_ = samples[start + count - 1];
+    }
+
+    publishStats();
+}
+
+// Same equation as solveNode, scaled by R:
+// f(V) = V - Vin + 2*R*Is*sinh(V/nVt), f'(V) = 1 + 2*R*Is*cosh(V/nVt)/nVt
+// f is convex on the side of Vin, so Newton started there (|V| >= |root|)
+// converges monotonically. nVt*asinh(Vin/(2*R*Is)) is such a point; the warm
+// start (V on entry) replaces it when it lies between it and the root.
+// Each lane also keeps a bracket of the root, a step leaving it is bisected.
+void DiodeClipper::solveLanes(float* V, const float* Vin, float* iterations, float* unconverged) const
+{
+    const float A = 2.0f * R_ * Is_;
+    const float invA = 1.0f / A;
+    const float invNVt = 1.0f / nVt_;
+
+    float lo[kLanes];
+    float hi[kLanes];
+    float x[kLanes];
+    float ex[kLanes];
+    float active[kLanes];
+
+    // --- start point ---
+    for (int l = 0; l < kLanes; ++l)
+    {
+        float y = std::min(std::fabs(Vin[l]) * invA, 1e18f);
+        x[l] = y + std::sqrt(y * y + 1.0f);
+    }
+
+    fastLog(x, ex, kLanes);
+
+    for (int l = 0; l < kLanes; ++l)
+    {
+        lo[l] = std::min(0.0f, Vin[l]);
+        hi[l] = std::max(0.0f, Vin[l]);
+
+        float bound = std::copysign(std::min(nVt_ * ex[l], std::fabs(Vin[l])), Vin[l]);
+        ex[l] = bound;
+        x[l] = V[l] * invNVt;
+    }
+
+    fastExp(x, active, kLanes);
+
+    for (int l = 0; l < kLanes; ++l)
+    {
+        // f(warm) has the sign of Vin -> warm start is on the convex side
+        float sinh_x = 0.5f * (active[l] - 1.0f / active[l]);
+        float f = V[l] - Vin[l] + A * sinh_x;
+        bool useWarm = (f * Vin[l] >= 0.0f) && (std::fabs(V[l]) < std::fabs(ex[l]));
+
+        V[l] = useWarm ? V[l] : ex[l];
+        active[l] = 1.0f;
+        iterations[l] = 0.0f;
+    }
+
+    // --- masked Newton iterations ---
+    for (int i = 0; i < maxIter_; ++i)
+    {
+        for (int l = 0; l < kLanes; ++l)
+            x[l] = V[l] * invNVt;
+
+        fastExp(x, ex, kLanes);
+
+        float numActive = 0.0f;
+
+        for (int l = 0; l < kLanes; ++l)
+        {
+            float emx = 1.0f / ex[l];
+            float sinh_x = 0.5f * (ex[l] - emx);
+            float cosh_x = 0.5f * (ex[l] + emx);
+
+            float f = V[l] - Vin[l] + A * sinh_x;
+            float df = 1.0f + A * cosh_x * invNVt;
+
+            lo[l] = (f > 0.0f) ? lo[l] : V[l];
+            hi[l] = (f > 0.0f) ? V[l] : hi[l];
+
+            float next = V[l] - f / df;
+            bool inside = (next >= lo[l]) && (next <= hi[l]);
+            next = inside ? next : 0.5f * (lo[l] + hi[l]);
+
+            float dV = next - V[l];
+            iterations[l] += active[l];
+            V[l] = (active[l] != 0.0f) ? next : V[l];
+            active[l] = (active[l] != 0.0f) && (std::fabs(dV) >= tol_) ? 1.0f : 0.0f;
+            numActive += active[l];
+        }
+
+        if (numActive == 0.0f)
+            break;
+    }
+
+    for (int l = 0; l < kLanes; ++l)
+        unconverged[l] = active[l];
+}
+
+// called from the message thread (setters)
+void DiodeClipper::requestTableRebuild()
+{
+    if (mode_ == Mode::Exact)
+    {
+        tables.invalidate();
+        return;
+    }
+
+    const double R = R_;
+    const double Is = Is_;
+    const double nVt = nVt_;
+
+    tables.requestBuild([R, Is, nVt] { return buildTable(R, Is, nVt); });
+}
+
+const DiodeClipper::Table* DiodeClipper::acquireTable()
+{
+    bool changed = false;
+    const Table* t = tables.acquire(&changed);
+
+    if (changed)
+        adaaReset = true; // history antiderivatives came from the old table
+
+    return t;
+}
+
+DiodeClipper::Table DiodeClipper::buildTable(double R, double Is, double nVt)
+{
+    Table t;
+
+    const double step = 2.0 * tableRange / (double)(tableSize - 1u);
+
+    t.vMin = (float)-tableRange;
+    t.step = (float)step;
+    t.invStep = (float)(1.0 / step);
+    t.y.resize(tableSize);
+    t.dy.resize(tableSize);
+
+    for (uint32_t i = 0; i < tableSize; ++i)
+    {
+        double Vin = -tableRange + i * step;
+
+        if (R <= 0.0 || Is <= 0.0 || nVt <= 0.0)
+        {
+            t.y[i] = (float)Vin;
+            t.dy[i] = (float)step;
+            continue;
+        }
+
+        double V = solveNodeExact(Vin, R, Is, nVt);
+
+        // dVout/dVin = 1 / (1 + 2*R*Is*cosh(V/nVt)/nVt)
+        double slope = 1.0 / (1.0 + 2.0 * R * Is * std::cosh(V / nVt) / nVt);
+
+        t.y[i] = (float)V;
+        t.dy[i] = (float)(slope * step);
+    }
+
+    // antiderivatives of the interpolated curve (exact integrals of the cubic
+    // segments), integrated outwards from Vin = 0 to keep their values small
+    t.F1.assign(tableSize, 0.0);
+    t.F2.assign(tableSize, 0.0);
+
+    const uint32_t mid = tableSize / 2u;
+
+    for (uint32_t i = mid; i + 1u < tableSize; ++i)
+    {
+        double y0 = t.y[i], m0 = t.dy[i], y1 = t.y[i + 1u], m1 = t.dy[i + 1u];
+        t.F1[i + 1u] = t.F1[i] + step * hermiteG(1.0, y0, m0, y1, m1);
+        t.F2[i + 1u] = t.F2[i] + step * (t.F1[i] + step * hermiteK(1.0, y0, m0, y1, m1));
+    }
+
+    for (uint32_t i = mid; i > 0; --i)
+    {
+        double y0 = t.y[i - 1u], m0 = t.dy[i - 1u], y1 = t.y[i], m1 = t.dy[i];
+        t.F1[i - 1u] = t.F1[i] - step * hermiteG(1.0, y0, m0, y1, m1);
+        t.F2[i - 1u] = t.F2[i] - step * (t.F1[i - 1u] + step * hermiteK(1.0, y0, m0, y1, m1));
+    }
+
+    return t;
+}
+
+// cubic Hermite between grid points, linear asymptotes outside the grid
+float DiodeClipper::Table::lookup(float Vin) const
+{
+    const uint32_t last = (uint32_t)y.size() - 1u;
+    float x = (Vin - vMin) * invStep;
+
+    if (!(x > 0.0f))
+        return y[0] + dy[0] * x;
+
+    if (x >= (float)last)
+        return y[last] + dy[last] * (x - (float)last);
+
+    uint32_t i = (uint32_t)x;
+    float t = x - (float)i;
+    float t2 = t * t;
+    float t3 = t2 * t;
+
+    return (2.0f * t3 - 3.0f * t2 + 1.0f) * y[i]
+        + (t3 - 2.0f * t2 + t) * dy[i]
+        + (3.0f * t2 - 2.0f * t3) * y[i + 1u]
+        + (t3 - t2) * dy[i + 1u];
+}
+
+// outside the grid the curve is linear, so F1 / F2 continue as polynomials
+double DiodeClipper::Table::antiderivative1(double Vin) const
+{
+    const uint32_t last = (uint32_t)y.size() - 1u;
+    double x = (Vin - vMin) * invStep;
+
+    if (!(x > 0.0) || x >= (double)last)
+    {
+        uint32_t e = (x > 0.0) ? last : 0u;
+        double d = Vin - (vMin + e * (double)step);
+        return F1[e] + y[e] * d + 0.5 * (dy[e] * invStep) * d * d;
+    }
+
+    uint32_t i = (uint32_t)x;
+    double t = x - (double)i;
+
+    return F1[i] + step * hermiteG(t, y[i], dy[i], y[i + 1u], dy[i + 1u]);
+}
+
+double DiodeClipper::Table::antiderivative2(double Vin) const
+{
+    const uint32_t last = (uint32_t)y.size() - 1u;
+    double x = (Vin - vMin) * invStep;
+
+    if (!(x > 0.0) || x >= (double)last)
+    {
+        uint32_t e = (x > 0.0) ? last : 0u;
+        double d = Vin - (vMin + e * (double)step);
+        return F2[e] + F1[e] * d + 0.5 * y[e] * d * d + (dy[e] * invStep) * d * d * d / 6.0;
+    }
+
+    uint32_t i = (uint32_t)x;
+    double t = x - (double)i;
+
+    return F2[i] + step * (F1[i] * t + step * hermiteK(t, y[i], dy[i], y[i + 1u], dy[i + 1u]));
 }
 
 // We model two anti-parallel diodes between the node and ground.
@@ -32,7 +587,7 @@ float DiodeClipper::process(float input)
 // Circuit equation: (Vin - Vout) / R = Id(Vout)
 // Solve f(Vout) = (Vin - Vout)/R - 2*Is*sinh(Vout/nVt) = 0
 
-float DiodeClipper::solveNode(float Vin) const
+float DiodeClipper::solveNode(float Vin, Stats& stats) const
 {
     // Quick path: if R is very large (no clipping) just return Vin
     if (R_ <= 0.0f || Is_ <= 0.0f || nVt_ <= 0.0f)
@@ -40,9 +595,13 @@ float DiodeClipper::solveNode(float Vin) const
 
     // Initial guess: clamp to Vin but keep reasonable
     float V = std::clamp(Vin, -1.0f, 1.0f);
+    int iterations = 0;
+    bool converged = false;
 
     for (int i = 0; i < maxIter_; ++i)
     {
+        iterations++;
+
         // Id = 2*Is*sinh(V/nVt)
         float x = V / nVt_;
         // For large x, sinh/ cosh can overflow; use safe checks
@@ -50,13 +609,13 @@ float DiodeClipper::solveNode(float Vin) const
         float cosh_x;
         if (std::fabs(x) < 20.0f)
         {
-            sinh_x = std::sinh(x);
-            cosh_x = std::cosh(x);
+            sinh_x = fastSinh(x);
+            cosh_x = fastCosh(x);
         }
         else
         {
             // For very large |x|, sinh ~ 0.5*exp(|x|)*sign(x), cosh ~ 0.5*exp(|x|)
-            float ex = std::exp(std::fabs(x));
+            float ex = fastExp(std::fabs(x));
             sinh_x = (x >= 0.0f) ? 0.5f * ex : -0.5f * ex;
             cosh_x = 0.5f * ex;
         }
@@ -83,15 +642,21 @@ float DiodeClipper::solveNode(float Vin) const
         V += dV;
 
         if (std::fabs(dV) < tol_)
+        {
+            converged = true;
             break;
+        }
     }
 
+    bool fallback = !std::isfinite(V);
+    countSolve(stats, Vin, iterations, !converged, fallback);
+
     // If Newton diverged to NaN or inf, fallback to a smooth clipper
-    if (!std::isfinite(V))
+    if (fallback)
     {
         // soft fallback: gentle tanh-style clipping
         float gain = 1.0f / (10.0f * nVt_);
-        return std::tanh(Vin * gain) / gain;
+        return fastTanh(Vin * gain) / gain;
     }
 
     return V;
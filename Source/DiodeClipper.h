@@ -11,31 +11,114 @@
 #pragma once
 
 #include <cstdint>
+#include <atomic>
+#include <vector>
+#include "BackgroundTable.h"
 
 
 class DiodeClipper
 {
 public:
+#if defined(__AVX512F__)
+    static constexpr int kLanes = 16;
+#else
+    static constexpr int kLanes = 8;
+#endif
+
+    // Exact: Newton solve per sample
+    // Table: Vout(Vin) lookup (the clipper is memoryless), built on a background
+    //        thread whenever R, Is or nVt change; exact solve until it is ready
+    // Adaa1, Adaa2: antiderivative anti-aliasing of 1st / 2nd order on the same
+    //        table (latency 0.5 / 1 sample), cheaper alternative to oversampling
+    enum class Mode { Exact, Table, Adaa1, Adaa2 };
+
+    static constexpr int kHistogramBins = 16; // iteration counts 0 .. 14, last bin 15 or more
+    static constexpr int kLevelBins = 10; // |Vin| octaves: < 1/16 V, < 1/8 V, ... , < 16 V, >= 16 V
+
+    // Convergence of the Newton solves (Exact mode, and the other modes while
+    // their table is not ready). Lookups and ADAA are not counted.
+    struct Stats
+    {
+        uint64_t samples = 0;
+        uint64_t iterations = 0;
+        uint64_t maxIterHits = 0; // solves stopped by maxIter before reaching tol
+        uint64_t fallbacks = 0; // non finite results replaced by the tanh clipper
+        uint64_t histogram[kHistogramBins] = {}; // samples per iteration count
+        uint64_t levelSamples[kLevelBins] = {}; // samples per input level
+        uint64_t levelIterations[kLevelBins] = {}; // iterations per input level
+    };
+
     // R: series resistance (ohms)
     // Is: diode saturation current (A)
     // nVt: ideality * thermal voltage (V) (typically ~25.85e-3 * n)
     DiodeClipper(float R = 1000.0f, float Is = 1e-9f, float nVt = 0.02585f,
         int maxIter = 50, float tol = 1e-7f);
+    ~DiodeClipper();
+
+    DiodeClipper(const DiodeClipper&) = delete;
+    DiodeClipper& operator=(const DiodeClipper&) = delete;
 
 
     // Process one sample (mono). Returns clipped output.
     float process(float input);
 
+    // Process a block in place. Exact mode solves kLanes samples at once with
+    // a fixed iteration budget (maxIter), so the cost per block is bounded.
+    void processBlock(float* samples, int numSamples);
+
 
     // Setters / getters
     void setSeriesResistance(float R);
     void setSaturationCurrent(float Is);
     void setNVt(float nVt);
 
+    void setMode(Mode mode);
+    Mode getMode() const { return mode_; }
+    bool isTableReady() const;
+
+    // Counters are accumulated by the audio thread and published once per
+    // block (every statsFlushInterval samples for process()), lock free.
+    // Both can be called from any thread. Only Newton solves are counted, so in
+    // Table / ADAA modes they stay empty once the table is ready.
+    Stats getStats() const;
+    void resetStats();
+
 
 private:
-    // Solve for the node voltage Vout given Vin using Newton-Raphson
-    float solveNode(float Vin) const;
+    // Solve for the node voltage Vout given Vin using Newton-Raphson,
+    // the solve is counted in stats
+    float solveNode(float Vin, Stats& stats) const;
+
+    // Newton solve of kLanes samples in parallel: lanes that converged keep
+    // their value (masked update), the loop ends when all lanes converged.
+    // Per lane iteration count and 1 for lanes stopped by maxIter.
+    void solveLanes(float* V, const float* Vin, float* iterations, float* unconverged) const;
+
+    static void countSolve(Stats& stats, float Vin, int iterations, bool unconverged, bool fallback);
+    void publishStats(); // audio thread
+
+    // Vout on a uniform Vin grid, with slopes for cubic Hermite interpolation
+    struct Table
+    {
+        float vMin = 0.0f;
+        float step = 0.0f;
+        float invStep = 0.0f;
+        std::vector<float> y;
+        std::vector<float> dy; // dVout/dVin * step
+        std::vector<double> F1; // antiderivatives of the interpolated curve, 0 at Vin = 0
+        std::vector<double> F2;
+
+        float lookup(float Vin) const;
+        double antiderivative1(double Vin) const;
+        double antiderivative2(double Vin) const;
+    };
+
+    static Table buildTable(double R, double Is, double nVt);
+
+    float processAdaa(const Table& t, float x);
+
+    void requestTableRebuild();
+    const Table* acquireTable(); // audio thread
 
 
     float R_; // series resistor
@@ -43,4 +126,28 @@ private:
     float nVt_; // ideality * thermal voltage
     int maxIter_;
     float tol_;
+    Mode mode_ = Mode::Exact;
+    float lastOutput_ = 0.0f; // warm start of the block solver
+
+    // ADAA history (previous inputs and their antiderivatives)
+    bool adaaReset = true;
+    double adaaX1 = 0.0;
+    double adaaX2 = 0.0;
+    double adaaF1 = 0.0; // F1(x1)
+    double adaaF2 = 0.0; // F2(x1)
+    double adaaD = 0.0; // (F2(x1) - F2(x2)) / (x1 - x2)
+
+    BackgroundTable<Table> tables;
+
+    static constexpr uint64_t statsFlushInterval = 512u;
+
+    // counters not yet published (audio thread) and the published totals
+    Stats pendingStats;
+    std::atomic<uint64_t> statSamples{ 0 };
+    std::atomic<uint64_t> statIterations{ 0 };
+    std::atomic<uint64_t> statMaxIterHits{ 0 };
+    std::atomic<uint64_t> statFallbacks{ 0 };
+    std::atomic<uint64_t> statHistogram[kHistogramBins] = {};
+    std::atomic<uint64_t> statLevelSamples[kLevelBins] = {};
+    std::atomic<uint64_t> statLevelIterations[kLevelBins] = {};
 };
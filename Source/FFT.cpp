@@ -8,6 +8,7 @@
   ==============================================================================
 */
 
+#include <algorithm>
 #include <cmath>
 #include "FFT.h"
 
@@ -25,15 +26,32 @@ FFT::FFT()
 
 }
 
+void FFT::prepare(uint32_t size)
+{
+    if (size <= (uint32_t)twiddleRe.size())
+        return;
+
+    twiddleRe.assign(size, 1.0f);
+    twiddleIm.assign(size, 0.0f);
+
+    // the table of a smaller size is the first half of this one
+    for (uint32_t le2 = 1; le2 < size; le2 *= 2)
+    {
+        for (uint32_t j = 0; j < le2; j++)
+        {
+            twiddleRe[le2 + j] = (float)std::cos(M_PI * j / le2);
+            twiddleIm[le2 + j] = (float)-std::sin(M_PI * j / le2);
+        }
+    }
+}
+
 void FFT::FFT_process(float* Re, float* Im, uint32_t size)
 {
-    uint32_t nm1 = size - 1;
     uint32_t nd2 = size / 2;
-    uint32_t m = (uint32_t)(log(size) / log(2));
     uint32_t j = nd2;
-    uint32_t k, le, le2, ip;
+    uint32_t k, le;
 
-    float tr, ti, ur, ui, sr, si;
+    float tr, ti;
 
     // bit reversal
     for (uint32_t i = 1; i <= (size - 2); i++)
@@ -59,30 +77,45 @@ void FFT::FFT_process(float* Re, float* Im, uint32_t size)
         j += k;
     }
 
-    for (uint32_t i0 = 1; i0 <= m; i0++)
+    prepare(size);
+
+    // stages up to cacheBlock points run chunk by chunk while the chunk is
+    // in cache, the larger ones as one sequential pass each
+    const uint32_t cacheBlock = std::min(size, 4096u);
+
+    for (uint32_t chunk = 0; chunk < size; chunk += cacheBlock)
     {
-        le = pow(2, i0);
-        le2 = le / 2;
-        ur = 1.0f;
-        ui = 0.0f;
-        sr = cos(M_PI / (float)le2);
-        si = -sin(M_PI / (float)le2);
-
-        for (uint32_t i1 = 1; i1 <= le2; i1++)
+        for (le = 2; le <= cacheBlock; le *= 2)
+            butterflies(Re, Im, le, chunk, chunk + cacheBlock);
+    }
+
+    for (le = cacheBlock * 2; le <= size; le *= 2)
+        butterflies(Re, Im, le, 0, size);
+}
+
+// one radix-2 stage of span le over [begin, end); blocks outer, twiddles
+// inner, read from the table so the butterflies are independent (vectorized)
+void FFT::butterflies(float* Re, float* Im, uint32_t le, uint32_t begin, uint32_t end)
+{
+    const uint32_t le2 = le / 2;
+    const float* wr = &twiddleRe[le2];
+    const float* wi = &twiddleIm[le2];
+
+    for (uint32_t block = begin; block < end; block += le)
+    {
+        float* re1 = Re + block;
+        float* im1 = Im + block;
+        float* re2 = re1 + le2;
+        float* im2 = im1 + le2;
+
+        for (uint32_t j = 0; j < le2; j++)
         {
-            for (uint32_t i2 = i1 - 1; i2 <= nm1; i2 += le)
-            {
-                ip = i2 + le2;
-                tr = (Re[ip] * ur) - (Im[ip] * ui);
-                ti = (Re[ip] * ui) + (Im[ip] * ur);
-                Re[ip] = Re[i2] - tr;
-                Im[ip] = Im[i2] - ti;
-                Re[i2] = Re[i2] + tr;
-                Im[i2] = Im[i2] + ti;
-            }
-            tr = ur;
-            ur = (tr * sr) - (ui * si);
-            ui = (tr * si) + (ui * sr);
+            float tr = (re2[j] * wr[j]) - (im2[j] * wi[j]);
+            float ti = (re2[j] * wi[j]) + (im2[j] * wr[j]);
+            re2[j] = re1[j] - tr;
+            im2[j] = im1[j] - ti;
+            re1[j] = re1[j] + tr;
+            im1[j] = im1[j] + ti;
         }
     }
 }
@@ -153,3 +186,97 @@ uint32_t FFT::calculateFFTWindow(uint32_t length)
     }
     return fftSize;
 }
+
+void FFT::realFFT(float* Re, float* Im, uint32_t size)
+{
+    const uint32_t half = size / 2;
+
+    // z[k] = x[2k] + i x[2k + 1] (in place, Re[k] is read before it is overwritten)
+    for (uint32_t k = 0; k < half; k++)
+    {
+        Im[k] = Re[2 * k + 1];
+        Re[k] = Re[2 * k];
+    }
+
+    FFT_process(Re, Im, half);
+
+    // X[k] = E[k] + W^k O[k], X[half - k] = conj(E[k] - W^k O[k]), W = e^(-2 pi i / size)
+    float z0 = Re[0];
+    Re[0] = z0 + Im[0];
+    Re[half] = z0 - Im[0];
+    Im[0] = 0.0f;
+    Im[half] = 0.0f;
+
+    const double sr = std::cos(2.0 * M_PI / size);
+    const double si = -std::sin(2.0 * M_PI / size);
+    double wr = sr;
+    double wi = si;
+
+    for (uint32_t k = 1; k <= half / 2; k++)
+    {
+        uint32_t m = half - k;
+        float er = 0.5f * (Re[k] + Re[m]);
+        float ei = 0.5f * (Im[k] - Im[m]);
+        float or_ = 0.5f * (Im[k] + Im[m]);
+        float oi = -0.5f * (Re[k] - Re[m]);
+
+        float tr = (float)(or_ * wr - oi * wi);
+        float ti = (float)(or_ * wi + oi * wr);
+
+        Re[k] = er + tr;
+        Im[k] = ei + ti;
+        Re[m] = er - tr;
+        Im[m] = -(ei - ti);
+
+        double t = wr;
+        wr = (t * sr) - (wi * si);
+        wi = (t * si) + (wi * sr);
+    }
+}
+
+void FFT::realIFFT(float* Re, float* Im, uint32_t size)
+{
+    const uint32_t half = size / 2;
+
+    // E[k] = (X[k] + conj(X[half - k])) / 2, O[k] = conj(W^k) (X[k] - conj(X[half - k])) / 2, Z = E + iO
+    float x0 = Re[0];
+    float xh = Re[half];
+    Re[0] = 0.5f * (x0 + xh);
+    Im[0] = 0.5f * (x0 - xh);
+
+    const double sr = std::cos(2.0 * M_PI / size);
+    const double si = std::sin(2.0 * M_PI / size);
+    double wr = sr;
+    double wi = si;
+
+    for (uint32_t k = 1; k <= half / 2; k++)
+    {
+        uint32_t m = half - k;
+        float er = 0.5f * (Re[k] + Re[m]);
+        float ei = 0.5f * (Im[k] - Im[m]);
+        float dr = 0.5f * (Re[k] - Re[m]);
+        float di = 0.5f * (Im[k] + Im[m]);
+
+        float or_ = (float)(dr * wr - di * wi);
+        float oi = (float)(dr * wi + di * wr);
+
+        // Z[k] = E + iO, Z[half - k] = conj(E) + i conj(O)
+        Re[k] = er - oi;
+        Im[k] = ei + or_;
+        Re[m] = er + oi;
+        Im[m] = -ei + or_;
+
+        double t = wr;
+        wr = (t * sr) - (wi * si);
+        wi = (t * si) + (wi * sr);
+    }
+
+    IFFT_process(Re, Im, half);
+
+    // x[2k] = Re z[k], x[2k + 1] = Im z[k], backwards so nothing unread is overwritten
+    for (uint32_t k = half; k-- > 0;)
+    {
+        Re[2 * k + 1] = Im[k];
+        Re[2 * k] = Re[k];
+    }
+}
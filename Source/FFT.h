@@ -11,17 +11,31 @@
 #pragma once
 
 #include "stdint.h"
+#include <vector>
 
 class FFT
 {
 public:
     FFT();
+    // twiddle table for transforms up to size points (grows only), call off the
+    // audio thread; FFT_process builds it on first use otherwise
+    void prepare(uint32_t size);
     void FFT_process(float* Re, float* Im, uint32_t size);
     void IFFT_process(float* Re, float* Im, uint32_t size);
+
+    // size real samples in Re -> bins 0..size / 2 in Re / Im (Im needs size / 2 + 1 entries)
+    void realFFT(float* Re, float* Im, uint32_t size);
+    // inverse of realFFT, bins 0..size / 2 -> size real samples in Re
+    void realIFFT(float* Re, float* Im, uint32_t size);
     void rectangularToPolar(float* Re, float* Im, float* Mag, float* Phase, uint32_t size);
     void polarToRectangular(float* Mag, float* Phase, float* Re, float* Im, uint32_t size);
     uint32_t calculateFFTWindow(uint32_t length);
 
 private:
+    void butterflies(float* Re, float* Im, uint32_t le, uint32_t begin, uint32_t end);
+
+    // w^j of every stage, stage of span le at [le / 2, le), computed in double
+    std::vector<float> twiddleRe;
+    std::vector<float> twiddleIm;
 
 };
@@ -0,0 +1,347 @@
+/*
+  ==============================================================================
+
+    FastMath.h
+    Created: 22 Oct 2026 10:05:37am
+    Author:  dkuzn
+
+    Polynomial approximations of the transcendental functions used in the
+    DSP hot paths. All of them are branch free (selects only), so the block
+    versions at the bottom are vectorized by the compiler (SSE2 / AVX / NEON)
+    without intrinsics. Error bounds are checked against libm by
+    dkAmpTools check-fastmath.
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace fastmath_detail
+{
+    inline float asFloat(int32_t i)
+    {
+        float f;
+        std::memcpy(&f, &i, sizeof(f));
+        return f;
+    }
+
+    inline int32_t asInt(float f)
+    {
+        int32_t i;
+        std::memcpy(&i, &f, sizeof(i));
+        return i;
+    }
+
+    // round to nearest for |x| < 2^22 (adding 1.5 * 2^23 drops the fraction bits)
+    inline float roundNearest(float x)
+    {
+        const float magic = 12582912.0f;
+        return (x + magic) - magic;
+    }
+
+    // 2^k for integer valued k in [-126, 127]
+    inline float pow2i(float k)
+    {
+        return asFloat(((int32_t)k + 127) << 23);
+    }
+
+    // e^r for |r| <= ln2 / 2
+    inline float expReduced(float r)
+    {
+        float p = 1.9875691500e-4f;
+        p = p * r + 1.3981999507e-3f;
+        p = p * r + 8.3334519073e-3f;
+        p = p * r + 4.1665795894e-2f;
+        p = p * r + 1.6666665459e-1f;
+        p = p * r + 5.0000001201e-1f;
+        return (p * r * r + r) + 1.0f;
+    }
+
+    // sin(r), cos(r) for |r| <= pi / 4
+    inline float sinReduced(float r)
+    {
+        float r2 = r * r;
+        float p = 2.7557319224e-6f;
+        p = p * r2 - 1.9841269841e-4f;
+        p = p * r2 + 8.3333333333e-3f;
+        p = p * r2 - 1.6666666667e-1f;
+        return r + r * r2 * p;
+    }
+
+    inline float cosReduced(float r)
+    {
+        float r2 = r * r;
+        float p = -2.7557319224e-7f;
+        p = p * r2 + 2.4801587302e-5f;
+        p = p * r2 - 1.3888888889e-3f;
+        p = p * r2 + 4.1666666667e-2f;
+        p = p * r2 - 0.5f;
+        return 1.0f + r2 * p;
+    }
+
+    // x = j * pi/2 + r (Cody-Waite, three parts of pi/2), valid for |x| < 8192
+    inline float reduceHalfPi(float x, int32_t& quadrant)
+    {
+        float j = roundNearest(x * 0.636619772f);
+        quadrant = (int32_t)j;
+        float r = x - j * 1.5703125f;
+        r -= j * 4.83751297e-4f;
+        r -= j * 7.54978995e-8f;
+        return r;
+    }
+
+    // x = 2^e * m, m in [sqrt(1/2), sqrt(2)): returns e and ln(m)
+    inline void logParts(float x, float& e, float& lnM)
+    {
+        // shift by sqrt(1/2) first, so the mantissa is centered around 1
+        int32_t shifted = asInt(x) - 0x3f3504f3;
+        e = (float)(shifted >> 23);
+        float m = asFloat((shifted & 0x007fffff) + 0x3f3504f3);
+
+        // ln(m) = 2 * atanh(s), s = (m - 1) / (m + 1), |s| < 0.172
+        float s = (m - 1.0f) / (m + 1.0f);
+        float s2 = s * s;
+        float p = 2.0f / 9.0f;
+        p = p * s2 + 2.0f / 7.0f;
+        p = p * s2 + 2.0f / 5.0f;
+        p = p * s2 + 2.0f / 3.0f;
+        p = p * s2 + 2.0f;
+        lnM = p * s;
+    }
+
+    // sin of x given as quadrant and reduced argument
+    inline float sinQuadrant(int32_t quadrant, float r)
+    {
+        float s = sinReduced(r);
+        float c = cosReduced(r);
+        float v = (quadrant & 1) ? c : s;
+        return (quadrant & 2) ? -v : v;
+    }
+}
+
+/**
+@fastExp
+\ingroup Fast-Math
+
+@brief e^x, relative error < 3e-7 for x in [-87, 88] (clamped outside)
+\param x - the input value
+\return e^x
+*/
+inline float fastExp(float x)
+{
+    using namespace fastmath_detail;
+
+    x = std::min(std::max(x, -87.0f), 88.0f);
+    float k = roundNearest(x * 1.44269504f);
+
+    // ln2 split in two parts, so r is exact
+    float r = (x - k * 0.693359375f) + k * 2.12194440e-4f;
+
+    return expReduced(r) * pow2i(k);
+}
+
+/**
+@fastExp2
+\ingroup Fast-Math
+
+@brief 2^x, relative error < 3e-7 for x in [-126, 127] (clamped outside)
+\param x - the input value
+\return 2^x
+*/
+inline float fastExp2(float x)
+{
+    using namespace fastmath_detail;
+
+    x = std::min(std::max(x, -126.0f), 127.0f);
+    float k = roundNearest(x);
+
+    return expReduced((x - k) * 0.693147181f) * pow2i(k);
+}
+
+/**
+@fastLog
+\ingroup Fast-Math
+
+@brief natural logarithm, error < 2e-7 + 1 ulp of the result for normal x > 0
+\param x - the input value (positive, normal)
+\return ln(x)
+*/
+inline float fastLog(float x)
+{
+    using namespace fastmath_detail;
+
+    float e, lnM;
+    logParts(x, e, lnM);
+
+    // ln2 split in two parts, e * hi is exact
+    return e * 0.693359375f + (lnM - e * 2.12194440e-4f);
+}
+
+/**
+@fastLog2
+\ingroup Fast-Math
+
+@brief base 2 logarithm, error < 3e-7 + 1 ulp of the result for normal x > 0
+\param x - the input value (positive, normal)
+\return log2(x)
+*/
+inline float fastLog2(float x)
+{
+    float e, lnM;
+    fastmath_detail::logParts(x, e, lnM);
+
+    return e + lnM * 1.44269504f;
+}
+
+/**
+@fastPow
+\ingroup Fast-Math
+
+@brief x^y = 2^(y * log2(x)), relative error < 3e-7 * (1 + |y * log2(x)|)
+\param x - the base (positive, normal)
+\param y - the exponent
+\return x^y
+*/
+inline float fastPow(float x, float y)
+{
+    return fastExp2(y * fastLog2(x));
+}
+
+/**
+@fastSinh
+\ingroup Fast-Math
+
+@brief hyperbolic sine, relative error < 4e-7 for |x| <= 87
+\param x - the input value
+\return sinh(x)
+*/
+inline float fastSinh(float x)
+{
+    float e = fastExp(x);
+    float big = 0.5f * (e - 1.0f / e);
+
+    // e - 1/e cancels near 0: Taylor series there
+    float x2 = x * x;
+    float small = x + x * x2 * (1.0f / 6.0f + x2 * (1.0f / 120.0f + x2 * (1.0f / 5040.0f)));
+
+    return (std::fabs(x) < 0.5f) ? small : big;
+}
+
+/**
+@fastCosh
+\ingroup Fast-Math
+
+@brief hyperbolic cosine, relative error < 4e-7 for |x| <= 87
+\param x - the input value
+\return cosh(x)
+*/
+inline float fastCosh(float x)
+{
+    float e = fastExp(x);
+    return 0.5f * (e + 1.0f / e);
+}
+
+/**
+@fastTanh
+\ingroup Fast-Math
+
+@brief hyperbolic tangent, absolute error < 2e-7
+\param x - the input value
+\return tanh(x)
+*/
+inline float fastTanh(float x)
+{
+    float e = fastExp(2.0f * std::min(std::fabs(x), 20.0f));
+    float t = 1.0f - 2.0f / (e + 1.0f);
+    return std::copysign(t, x);
+}
+
+/**
+@fastSin
+\ingroup Fast-Math
+
+@brief sine, absolute error < 2e-7 for |x| < 8192
+\param x - the input value [rad]
+\return sin(x)
+*/
+inline float fastSin(float x)
+{
+    int32_t quadrant;
+    float r = fastmath_detail::reduceHalfPi(x, quadrant);
+    return fastmath_detail::sinQuadrant(quadrant, r);
+}
+
+/**
+@fastCos
+\ingroup Fast-Math
+
+@brief cosine, absolute error < 2e-7 for |x| < 8192
+\param x - the input value [rad]
+\return cos(x)
+*/
+inline float fastCos(float x)
+{
+    int32_t quadrant;
+    float r = fastmath_detail::reduceHalfPi(x, quadrant);
+    return fastmath_detail::sinQuadrant(quadrant + 1, r);
+}
+
+// --- block versions (out may be equal to x) ---
+
+inline void fastExp(const float* x, float* out, uint32_t length)
+{
+    for (uint32_t i = 0; i < length; ++i)
+        out[i] = fastExp(x[i]);
+}
+
+inline void fastExp2(const float* x, float* out, uint32_t length)
+{
+    for (uint32_t i = 0; i < length; ++i)
+        out[i] = fastExp2(x[i]);
+}
+
+inline void fastLog(const float* x, float* out, uint32_t length)
+{
+    for (uint32_t i = 0; i < length; ++i)
+        out[i] = fastLog(x[i]);
+}
+
+inline void fastLog2(const float* x, float* out, uint32_t length)
+{
+    for (uint32_t i = 0; i < length; ++i)
+        out[i] = fastLog2(x[i]);
+}
+
+inline void fastSinh(const float* x, float* out, uint32_t length)
+{
+    for (uint32_t i = 0; i < length; ++i)
+        out[i] = fastSinh(x[i]);
+}
+
+inline void fastCosh(const float* x, float* out, uint32_t length)
+{
+    for (uint32_t i = 0; i < length; ++i)
+        out[i] = fastCosh(x[i]);
+}
+
+inline void fastTanh(const float* x, float* out, uint32_t length)
+{
+    for (uint32_t i = 0; i < length; ++i)
+        out[i] = fastTanh(x[i]);
+}
+
+inline void fastSin(const float* x, float* out, uint32_t length)
+{
+    for (uint32_t i = 0; i < length; ++i)
+        out[i] = fastSin(x[i]);
+}
+
+inline void fastCos(const float* x, float* out, uint32_t length)
+{
+    for (uint32_t i = 0; i < length; ++i)
+        out[i] = fastCos(x[i]);
+}
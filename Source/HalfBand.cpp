@@ -0,0 +1,261 @@
+/*
+  ==============================================================================
+
+    HalfBand.cpp
+    Created: 19 Oct 2026 11:02:17am
+    Author:  dkuzn
+
+  ==============================================================================
+*/
+
+#include "HalfBand.h"
+#include "Window.h"
+#include "VectorOps.h"
+#include <algorithm>
+#include <cmath>
+
+#ifndef M_PI
+namespace
+{
+    const double M_PI = std::acos(-1.0);
+}
+#endif
+
+
+HalfBandFilter::HalfBandFilter(uint32_t numCoeffs, double attenuationDB)
+{
+    numCoeffs = std::max(numCoeffs, 1u);
+
+    // windowed sinc with cutoff at fs/4: h[c + j] = 0.5 * sinc(j / 2) * w(j)
+    const double beta = kaiserBeta(attenuationDB);
+    const double halfLength = 2.0 * numCoeffs;
+    double sum = 0.0;
+
+    coeffs.resize(numCoeffs);
+
+    for (uint32_t i = 0; i < numCoeffs; ++i)
+    {
+        double j = 2.0 * i + 1.0;
+        double sinc = std::sin(M_PI * j * 0.5) / (M_PI * j * 0.5);
+        double h = 0.5 * sinc * kaiserWindow(j / halfLength, beta);
+
+        coeffs[i] = (float)h;
+        sum += h;
+    }
+
+    // unity DC gain: 0.5 + 2 * sum(coeffs) = 1
+    for (auto& c : coeffs)
+        c = (float)(c * 0.25 / sum);
+
+    // [c(K-1) .. c(0), c(0) .. c(K-1)]
+    numTaps = 2u * numCoeffs;
+    taps.resize(numTaps);
+
+    for (uint32_t i = 0; i < numCoeffs; ++i)
+    {
+        taps[numCoeffs - 1u - i] = coeffs[i];
+        taps[numCoeffs + i] = coeffs[i];
+    }
+
+    reset();
+}
+
+void HalfBandFilter::reset()
+{
+    decHistory.assign(2u * numTaps, 0.0f);
+    decCenter.assign(coeffs.size(), 0.0f);
+    intHistory.assign(2u * numTaps, 0.0f);
+    decPos = 0;
+    centerPos = 0;
+    intPos = 0;
+}
+
+float HalfBandFilter::decimate(float x0, float x1)
+{
+    // x0 phase meets all side taps
+    decHistory[decPos] = decHistory[decPos + numTaps] = x0;
+    decPos = (decPos + 1u == numTaps) ? 0u : decPos + 1u;
+
+    float y = dotProduct(&decHistory[decPos], taps.data(), numTaps);
+
+    // x1 phase meets only the center tap, numCoeffs pairs later; it is the same
+    // phase interpolate() puts the original samples on
+    y += 0.5f * decCenter[centerPos];
+    decCenter[centerPos] = x1;
+    centerPos = (centerPos + 1u == (uint32_t)decCenter.size()) ? 0u : centerPos + 1u;
+
+    return y;
+}
+
+void HalfBandFilter::interpolate(float x, float& y0, float& y1)
+{
+    intHistory[intPos] = intHistory[intPos + numTaps] = x;
+    intPos = (intPos + 1u == numTaps) ? 0u : intPos + 1u;
+
+    // win[0] = oldest, win[numTaps - 1] = newest sample
+    const float* win = &intHistory[intPos];
+
+    // zero stuffing doubles the gain of the taps: even output uses side taps, odd one the center tap
+    y0 = 2.0f * dotProduct(win, taps.data(), numTaps);
+    y1 = win[coeffs.size()];
+}
+
+uint32_t HalfBandFilter::getLatency() const
+{
+    return 2u * (uint32_t)coeffs.size() - 1u;
+}
+
+
+namespace
+{
+    // --- hiir polyphase IIR designer (PolyphaseIir2Designer) ---
+
+    double ipowp(double x, long n)
+    {
+        double z = 1.0;
+        while (n != 0)
+        {
+            if ((n & 1) != 0)
+                z *= x;
+            n >>= 1;
+            x *= x;
+        }
+        return z;
+    }
+
+    void computeTransitionParam(double& k, double& q, double transition)
+    {
+        k = std::tan((1.0 - transition * 2.0) * M_PI / 4.0);
+        k *= k;
+
+        double kksqrt = std::pow(1.0 - k * k, 0.25);
+        double e = 0.5 * (1.0 - kksqrt) / (1.0 + kksqrt);
+        double e2 = e * e;
+        double e4 = e2 * e2;
+        q = e * (1.0 + e4 * (2.0 + e4 * (15.0 + 150.0 * e4)));
+    }
+
+    double computeAccNum(double q, int order, int c)
+    {
+        int i = 0;
+        int j = 1;
+        double acc = 0.0;
+        double q_ii1;
+
+        do
+        {
+            q_ii1 = ipowp(q, i * (i + 1)) * std::sin((i * 2 + 1) * c * M_PI / order) * j;
+            acc += q_ii1;
+            j = -j;
+            ++i;
+        } while (std::fabs(q_ii1) > 1e-100);
+
+        return acc;
+    }
+
+    double computeAccDen(double q, int order, int c)
+    {
+        int i = 1;
+        int j = -1;
+        double acc = 0.0;
+        double q_i2;
+
+        do
+        {
+            q_i2 = ipowp(q, i * i) * std::cos(i * 2 * c * M_PI / order) * j;
+            acc += q_i2;
+            j = -j;
+            ++i;
+        } while (std::fabs(q_i2) > 1e-100);
+
+        return acc;
+    }
+
+    double computeCoef(int index, double k, double q, int order)
+    {
+        const int c = index + 1;
+        const double num = computeAccNum(q, order, c) * std::pow(q, 0.25);
+        const double den = computeAccDen(q, order, c) + 0.5;
+        const double ww = num / den;
+        const double wwsq = ww * ww;
+
+        const double x = std::sqrt((1.0 - wwsq * k) * (1.0 - wwsq / k)) / (1.0 + wwsq);
+        return (1.0 - x) / (1.0 + x);
+    }
+}
+
+
+void AllpassHalfBand::computeCoefficients(double* coefs, uint32_t numCoeffs, double transition)
+{
+    double k, q;
+    computeTransitionParam(k, q, transition);
+
+    const int order = (int)numCoeffs * 2 + 1;
+    for (uint32_t i = 0; i < numCoeffs; ++i)
+        coefs[i] = computeCoef((int)i, k, q, order);
+}
+
+AllpassHalfBand::AllpassHalfBand(uint32_t numCoeffs, double transition)
+{
+    numCoeffs = std::max(numCoeffs, 2u);
+
+    std::vector<double> design(numCoeffs);
+    computeCoefficients(design.data(), numCoeffs, transition);
+
+    coefs.assign(design.begin(), design.end());
+
+    reset();
+}
+
+void AllpassHalfBand::reset()
+{
+    decX.assign(coefs.size(), 0.0f);
+    decY.assign(coefs.size(), 0.0f);
+    intX.assign(coefs.size(), 0.0f);
+    intY.assign(coefs.size(), 0.0f);
+}
+
+float AllpassHalfBand::processChain(float x, const std::vector<float>& coefs, uint32_t first, float* xState, float* yState)
+{
+    for (uint32_t i = first; i < (uint32_t)coefs.size(); i += 2u)
+    {
+        // y = c * (x - y[n-1]) + x[n-1]
+        float y = (x - yState[i]) * coefs[i] + xState[i];
+        xState[i] = x;
+        yState[i] = y;
+        x = y;
+    }
+
+    return x;
+}
+
+// H(z) = 0.5 * (A0(z^2) + z^-1 * A1(z^2)): the newer sample goes through the
+// even sections, the older one (delayed by z^-1) through the odd ones
+float AllpassHalfBand::decimate(float x0, float x1)
+{
+    float a = processChain(x1, coefs, 0u, decX.data(), decY.data());
+    float b = processChain(x0, coefs, 1u, decX.data(), decY.data());
+
+    return 0.5f * (a + b);
+}
+
+// zero stuffing doubles the gain: the two branches are the two output phases
+void AllpassHalfBand::interpolate(float x, float& y0, float& y1)
+{
+    y0 = processChain(x, coefs, 0u, intX.data(), intY.data());
+    y1 = processChain(x, coefs, 1u, intX.data(), intY.data());
+}
+
+double AllpassHalfBand::getLatency() const
+{
+    // DC group delay of (c + z^-1) / (1 + c * z^-1) is (1 - c) / (1 + c).
+    // At DC H(z) averages both branches, so a pair delays by the sum of the two
+    // branch delays (the extra z^-1 of branch 1 is taken back by the decimator,
+    // which outputs at the newer of its two samples)
+    double delay = 0.0;
+
+    for (size_t i = 0; i < coefs.size(); ++i)
+        delay += (1.0 - coefs[i]) / (1.0 + coefs[i]);
+
+    return delay;
+}
@@ -0,0 +1,83 @@
+/*
+  ==============================================================================
+
+    HalfBand.h
+    Created: 19 Oct 2026 11:02:17am
+    Author:  dkuzn
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+
+// Linear phase half-band FIR for 2x decimation / interpolation.
+// Every second tap of a half-band filter is zero (except the center one = 0.5),
+// so in polyphase form one phase is a plain delay and the other one is
+// a contiguous dot product of 2 * numCoeffs taps (SIMD, see VectorOps.h).
+class HalfBandFilter
+{
+public:
+    // numCoeffs: non-zero taps on each side of the center, filter length = 4 * numCoeffs - 1
+    HalfBandFilter(uint32_t numCoeffs = 16, double attenuationDB = 90.0);
+
+    void reset();
+
+    // Two input samples (x0 older) -> one output sample at the half rate
+    float decimate(float x0, float x1);
+
+    // One input sample -> two output samples at the double rate (y0 first)
+    void interpolate(float x, float& y0, float& y1);
+
+    // Delay of a decimate/interpolate pair (in either order), in samples at the lower rate
+    uint32_t getLatency() const;
+
+private:
+    std::vector<float> coeffs; // side taps, coeffs[i] at distance 2i+1 from the center
+    std::vector<float> taps; // side taps of the polyphase branch: coeffs mirrored, 2 * numCoeffs
+
+    std::vector<float> decHistory; // x0 phase samples, written twice (ring without wrapping)
+    std::vector<float> decCenter; // x1 phase samples, only delayed (center tap)
+    std::vector<float> intHistory; // low rate samples, written twice
+    uint32_t decPos = 0;
+    uint32_t centerPos = 0;
+    uint32_t intPos = 0;
+    uint32_t numTaps = 0;
+};
+
+
+// Minimum phase half-band for 2x decimation / interpolation: two parallel
+// chains of first order allpass sections at the low rate (polyphase IIR,
+// elliptic design of hiir by L. de Soras). Much cheaper than the FIR for the
+// same attenuation, but the phase is not linear.
+class AllpassHalfBand
+{
+public:
+    // numCoeffs: allpass sections of both chains together,
+    // transition: transition band width relative to the high rate (0 - 0.5)
+    AllpassHalfBand(uint32_t numCoeffs = 8, double transition = 0.04);
+
+    void reset();
+
+    // Two input samples (x0 older) -> one output sample at the half rate
+    float decimate(float x0, float x1);
+
+    // One input sample -> two output samples at the double rate (y0 first)
+    void interpolate(float x, float& y0, float& y1);
+
+    // Group delay at DC of a decimate/interpolate pair, in samples at the lower rate
+    double getLatency() const;
+
+    static void computeCoefficients(double* coefs, uint32_t numCoeffs, double transition);
+
+private:
+    // chain of allpasses (c + z^-1) / (1 + c * z^-1), coefs[first], coefs[first + 2] ...
+    static float processChain(float x, const std::vector<float>& coefs, uint32_t first, float* xState, float* yState);
+
+    std::vector<float> coefs;
+    std::vector<float> decX, decY; // section states, indexed like coefs
+    std::vector<float> intX, intY;
+};
@@ -0,0 +1,128 @@
+/*
+  ==============================================================================
+
+    IRStore.cpp
+    Created: 19 Oct 2026 9:12:31am
+    Author:  dkuzn
+
+  ==============================================================================
+*/
+
+#include "IRStore.h"
+
+
+size_t IRPartitions::getSizeInBytes() const
+{
+    return (IR.size() + 2u * (size_t)numSegments * (size_t)fftSize) * sizeof(float);
+}
+
+bool IRStore::Key::operator<(const Key& other) const
+{
+    if (fileHash != other.fileHash) return fileHash < other.fileHash;
+    if (sampleRate != other.sampleRate) return sampleRate < other.sampleRate;
+    return partitionSize < other.partitionSize;
+}
+
+IRStore::IRStore()
+{
+}
+
+uint64_t IRStore::hashFile(const juce::File& file)
+{
+    juce::MemoryBlock data;
+    if (!file.loadFileAsData(data))
+        return 0;
+
+    // FNV-1a 64 bit
+    uint64_t hash = 14695981039346656037ull;
+    const uint8_t* bytes = static_cast<const uint8_t*>(data.getData());
+
+    for (size_t i = 0; i < data.getSize(); ++i)
+    {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+
+    return hash;
+}
+
+std::shared_ptr<const IRPartitions> IRStore::find(const Key& key)
+{
+    const juce::ScopedLock sl(lock);
+
+    auto it = entries.find(key);
+    if (it == entries.end())
+        return nullptr;
+
+    it->second.lastUsed = ++useCounter;
+    return it->second.partitions;
+}
+
+std::shared_ptr<const IRPartitions> IRStore::insert(const Key& key, std::shared_ptr<const IRPartitions> partitions)
+{
+    const juce::ScopedLock sl(lock);
+
+    // another instance could prepare the same IR in the meantime - keep the first one
+    auto& entry = entries[key];
+    if (entry.partitions == nullptr)
+        entry.partitions = std::move(partitions);
+
+    entry.lastUsed = ++useCounter;
+
+    evictUnused();
+
+    return entry.partitions;
+}
+
+void IRStore::trim()
+{
+    const juce::ScopedLock sl(lock);
+    evictUnused();
+}
+
+void IRStore::setByteBudget(size_t bytes)
+{
+    const juce::ScopedLock sl(lock);
+    byteBudget = bytes;
+    evictUnused();
+}
+
+size_t IRStore::getUnusedBytes()
+{
+    const juce::ScopedLock sl(lock);
+
+    size_t bytes = 0;
+    for (const auto& item : entries)
+    {
+        if (item.second.partitions.use_count() == 1)
+            bytes += item.second.partitions->getSizeInBytes();
+    }
+
+    return bytes;
+}
+
+void IRStore::evictUnused()
+{
+    for (;;)
+    {
+        size_t unusedBytes = 0;
+        auto oldest = entries.end();
+
+        for (auto it = entries.begin(); it != entries.end(); ++it)
+        {
+            // only the store holds it -> nobody uses this entry
+            if (it->second.partitions.use_count() != 1)
+                continue;
+
+            unusedBytes += it->second.partitions->getSizeInBytes();
+
+            if (oldest == entries.end() || it->second.lastUsed < oldest->second.lastUsed)
+                oldest = it;
+        }
+
+        if (unusedBytes <= byteBudget || oldest == entries.end())
+            break;
+
+        entries.erase(oldest);
+    }
+}
@@ -0,0 +1,79 @@
+/*
+  ==============================================================================
+
+    IRStore.h
+    Created: 19 Oct 2026 9:12:31am
+    Author:  dkuzn
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+#include "VectorOps.h"
+
+
+// Prepared IR spectra (one FFT per partition). Immutable once published
+// to the IRStore, so several plugin instances can read it at the same time.
+struct IRPartitions
+{
+    uint32_t fftSize = 0;
+    uint32_t numSegments = 0;
+    uint32_t IR_len = 0;
+    float normFactor = 1.0f;
+
+    AlignedBuffer IR; // time domain IR (resampled straight into it), used by the direct engine
+    std::vector<std::vector<float>> h_fft_Re;
+    std::vector<std::vector<float>> h_fft_Im;
+
+    size_t getSizeInBytes() const;
+};
+
+
+// Process-wide cache of prepared IR partition sets.
+// Entries are reference counted through shared_ptr; entries used by nobody
+// are kept until their total size exceeds byteBudget (oldest dropped first).
+class IRStore
+{
+public:
+    struct Key
+    {
+        uint64_t fileHash = 0;
+        uint32_t sampleRate = 0;
+        uint32_t partitionSize = 0;
+
+        bool operator<(const Key& other) const;
+    };
+
+    IRStore();
+
+    static uint64_t hashFile(const juce::File& file);
+
+    std::shared_ptr<const IRPartitions> find(const Key& key);
+    std::shared_ptr<const IRPartitions> insert(const Key& key, std::shared_ptr<const IRPartitions> partitions);
+
+    // call after dropping a reference, so unused entries are evicted
+    void trim();
+
+    void setByteBudget(size_t bytes);
+    size_t getUnusedBytes();
+
+private:
+    struct Entry
+    {
+        std::shared_ptr<const IRPartitions> partitions;
+        uint64_t lastUsed = 0;
+    };
+
+    void evictUnused(); // lock must be held
+
+    juce::CriticalSection lock;
+    std::map<Key, Entry> entries;
+    uint64_t useCounter = 0;
+    size_t byteBudget = 32u * 1024u * 1024u;
+};
@@ -0,0 +1,377 @@
+/*
+  ==============================================================================
+
+    NeuralAmp.cpp
+    Created: 23 Oct 2026 7:48:20pm
+    Author:  dkuzn
+
+  ==============================================================================
+*/
+
+#include "NeuralAmp.h"
+#include "FastMath.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // nested json arrays -> flat row major floats
+    void flatten(const juce::var& value, std::vector<float>& out)
+    {
+        if (value.isArray())
+        {
+            for (int i = 0; i < value.size(); ++i)
+                flatten(value[i], out);
+        }
+        else
+        {
+            out.push_back((float)value);
+        }
+    }
+
+    inline float sigmoid(float x)
+    {
+        return 0.5f + 0.5f * fastTanh(0.5f * x);
+    }
+
+    // out = bias + wIn * x + W h, W transposed (hidden x stride)
+    void gates(float* out, const float* bias, const float* wIn, float x,
+        const float* w, const float* h, uint32_t hidden, uint32_t stride)
+    {
+        uint32_t r = 0;
+
+#if DKAMP_USE_SSE2
+        // 16 rows in registers over all of h, the gates are stored once
+        const __m128 vx = _mm_set1_ps(x);
+
+        for (; r + 16u <= stride; r += 16u)
+        {
+            __m128 acc0 = _mm_add_ps(_mm_load_ps(bias + r), _mm_mul_ps(_mm_load_ps(wIn + r), vx));
+            __m128 acc1 = _mm_add_ps(_mm_load_ps(bias + r + 4u), _mm_mul_ps(_mm_load_ps(wIn + r + 4u), vx));
+            __m128 acc2 = _mm_add_ps(_mm_load_ps(bias + r + 8u), _mm_mul_ps(_mm_load_ps(wIn + r + 8u), vx));
+            __m128 acc3 = _mm_add_ps(_mm_load_ps(bias + r + 12u), _mm_mul_ps(_mm_load_ps(wIn + r + 12u), vx));
+
+            const float* col = w + r;
+            for (uint32_t j = 0; j < hidden; ++j, col += stride)
+            {
+                const __m128 hj = _mm_set1_ps(h[j]);
+                acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_load_ps(col), hj));
+                acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_load_ps(col + 4u), hj));
+                acc2 = _mm_add_ps(acc2, _mm_mul_ps(_mm_load_ps(col + 8u), hj));
+                acc3 = _mm_add_ps(acc3, _mm_mul_ps(_mm_load_ps(col + 12u), hj));
+            }
+
+            _mm_store_ps(out + r, acc0);
+            _mm_store_ps(out + r + 4u, acc1);
+            _mm_store_ps(out + r + 8u, acc2);
+            _mm_store_ps(out + r + 12u, acc3);
+        }
+
+        for (; r < stride; r += 4u)
+        {
+            __m128 acc = _mm_add_ps(_mm_load_ps(bias + r), _mm_mul_ps(_mm_load_ps(wIn + r), vx));
+
+            const float* col = w + r;
+            for (uint32_t j = 0; j < hidden; ++j, col += stride)
+                acc = _mm_add_ps(acc, _mm_mul_ps(_mm_load_ps(col), _mm_set1_ps(h[j])));
+
+            _mm_store_ps(out + r, acc);
+        }
+#else
+        for (; r < stride; ++r)
+            out[r] = bias[r] + wIn[r] * x;
+
+        for (uint32_t j = 0; j < hidden; ++j)
+        {
+            const float hj = h[j];
+            const float* col = w + (size_t)j * stride;
+
+            for (r = 0; r < stride; ++r)
+                out[r] += col[r] * hj;
+        }
+#endif
+    }
+
+#if DKAMP_USE_SSE2
+    // fastExp / fastTanh four at a time (same reduction and polynomial), 2^k needs integer ops
+    inline __m128 exp4(__m128 x)
+    {
+        const __m128 magic = _mm_set1_ps(12582912.0f);
+        __m128 k = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(1.44269504f)), magic), magic);
+        __m128 r = _mm_add_ps(_mm_sub_ps(x, _mm_mul_ps(k, _mm_set1_ps(0.693359375f))), _mm_mul_ps(k, _mm_set1_ps(2.12194440e-4f)));
+
+        __m128 p = _mm_set1_ps(1.9875691500e-4f);
+        p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(1.3981999507e-3f));
+        p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(8.3334519073e-3f));
+        p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(4.1665795894e-2f));
+        p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(1.6666665459e-1f));
+        p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(5.0000001201e-1f));
+        p = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_mul_ps(p, r), r), r), _mm_set1_ps(1.0f));
+
+        __m128i e = _mm_slli_epi32(_mm_add_epi32(_mm_cvttps_epi32(k), _mm_set1_epi32(127)), 23);
+        return _mm_mul_ps(p, _mm_castsi128_ps(e));
+    }
+
+    inline __m128 tanh4(__m128 x)
+    {
+        const __m128 signMask = _mm_set1_ps(-0.0f);
+        __m128 a = _mm_min_ps(_mm_andnot_ps(signMask, x), _mm_set1_ps(20.0f));
+        __m128 e = exp4(_mm_add_ps(a, a));
+        __m128 t = _mm_sub_ps(_mm_set1_ps(1.0f), _mm_div_ps(_mm_set1_ps(2.0f), _mm_add_ps(e, _mm_set1_ps(1.0f))));
+        return _mm_or_ps(t, _mm_and_ps(signMask, x));
+    }
+
+    inline __m128 sigmoid4(__m128 x)
+    {
+        const __m128 half = _mm_set1_ps(0.5f);
+        return _mm_add_ps(half, _mm_mul_ps(half, tanh4(_mm_mul_ps(half, x))));
+    }
+#endif
+}
+
+
+bool NeuralAmp::Model::isValid() const
+{
+    const size_t rows = getRows();
+
+    return hidden > 0u && hidden <= maxHidden
+        && weightIH.size() == rows
+        && weightHH.size() == rows * hidden
+        && biasIH.size() == rows
+        && biasHH.size() == rows
+        && weightOut.size() == hidden;
+}
+
+NeuralAmp::NeuralAmp()
+{
+}
+
+bool NeuralAmp::loadModel(const juce::File& file)
+{
+    Model model;
+
+    if (!parseModel(juce::JSON::parse(file), model))
+        return false;
+
+    return setModel(model);
+}
+
+bool NeuralAmp::parseModel(const juce::var& json, Model& model)
+{
+    const juce::var data = json["model_data"];
+    const juce::var weights = json["state_dict"];
+
+    if (!data.isObject() || !weights.isObject())
+        return false;
+
+    const juce::String unit = data["unit_type"].toString();
+
+    if (unit == "LSTM")
+        model.cell = Cell::LSTM;
+    else if (unit == "GRU")
+        model.cell = Cell::GRU;
+    else
+        return false;
+
+    if ((int)data["input_size"] > 1 || (int)data["output_size"] > 1)
+        return false;
+
+    // only the single layer rec.*_l0 weights are loaded, deeper stacks would silently drop layers
+    if (!data["num_layers"].isVoid() && (int)data["num_layers"] != 1)
+        return false;
+
+    model.hidden = (uint32_t)std::max(0, (int)data["hidden_size"]);
+    model.skip = (int)data["skip"] != 0;
+    model.sampleRate = data["sample_rate"].isVoid() ? 48000.0 : (double)data["sample_rate"];
+
+    flatten(weights["rec.weight_ih_l0"], model.weightIH);
+    flatten(weights["rec.weight_hh_l0"], model.weightHH);
+    flatten(weights["rec.bias_ih_l0"], model.biasIH);
+    flatten(weights["rec.bias_hh_l0"], model.biasHH);
+    flatten(weights["lin.weight"], model.weightOut);
+
+    std::vector<float> bias;
+    flatten(weights["lin.bias"], bias);
+    model.biasOut = bias.empty() ? 0.0f : bias[0];
+
+    return model.isValid();
+}
+
+bool NeuralAmp::setModel(const Model& model)
+{
+    if (!model.isValid())
+        return false;
+
+    const uint32_t gateCount = model.getRows() / model.hidden;
+
+    cell = model.cell;
+    hidden = model.hidden;
+    gateSize = (hidden + 3u) & ~3u;
+    stride = gateCount * gateSize;
+    skip = model.skip;
+    modelSampleRate = model.sampleRate;
+
+    weightHH.resize((size_t)hidden * stride);
+    weightIH.resize(stride);
+    biasX.resize(stride);
+    biasH.resize(stride);
+    weightOut.resize(gateSize);
+    gatesX.resize(stride);
+    gatesH.resize(stride);
+    h.resize(gateSize);
+    c.resize(gateSize);
+
+    // padding rows stay 0: their units keep h = c = 0
+    std::fill(weightHH.data(), weightHH.data() + weightHH.size(), 0.0f);
+    std::fill(weightIH.data(), weightIH.data() + stride, 0.0f);
+    std::fill(biasX.data(), biasX.data() + stride, 0.0f);
+    std::fill(biasH.data(), biasH.data() + stride, 0.0f);
+    std::fill(weightOut.data(), weightOut.data() + gateSize, 0.0f);
+
+    for (uint32_t g = 0; g < gateCount; ++g)
+    {
+        for (uint32_t u = 0; u < hidden; ++u)
+        {
+            const uint32_t src = g * hidden + u;
+            const uint32_t r = g * gateSize + u;
+
+            for (uint32_t j = 0; j < hidden; ++j)
+                weightHH.data()[(size_t)j * stride + r] = model.weightHH[(size_t)src * hidden + j];
+
+            weightIH.data()[r] = model.weightIH[src];
+
+            if (cell == Cell::LSTM)
+            {
+                biasX.data()[r] = model.biasIH[src] + model.biasHH[src];
+            }
+            else
+            {
+                biasX.data()[r] = model.biasIH[src];
+                biasH.data()[r] = model.biasHH[src];
+            }
+        }
+    }
+
+    std::copy(model.weightOut.begin(), model.weightOut.end(), weightOut.data());
+    biasOut = model.biasOut;
+
+    loaded = true;
+    reset();
+    return true;
+}
+
+void NeuralAmp::clearModel()
+{
+    loaded = false;
+}
+
+void NeuralAmp::reset()
+{
+    if (!loaded)
+        return;
+
+    std::fill(h.data(), h.data() + gateSize, 0.0f);
+    std::fill(c.data(), c.data() + gateSize, 0.0f);
+}
+
+void NeuralAmp::processBlock(float* samples, int numSamples)
+{
+    if (!loaded)
+        return;
+
+    if (cell == Cell::LSTM)
+        processLSTM(samples, numSamples);
+    else
+        processGRU(samples, numSamples);
+}
+
+void NeuralAmp::processLSTM(float* samples, int numSamples)
+{
+    const uint32_t G = gateSize;
+    float* a = gatesX.data();
+    float* hs = h.data();
+    float* cs = c.data();
+
+    for (int n = 0; n < numSamples; ++n)
+    {
+        const float x = samples[n];
+
+        gates(a, biasX.data(), weightIH.data(), x, weightHH.data(), hs, hidden, stride);
+
+        // c = f * c + i * g, h = o * tanh(c)
+#if DKAMP_USE_SSE2
+        for (uint32_t j = 0; j < G; j += 4u)
+        {
+            __m128 i = sigmoid4(_mm_load_ps(a + j));
+            __m128 f = sigmoid4(_mm_load_ps(a + G + j));
+            __m128 g = tanh4(_mm_load_ps(a + 2u * G + j));
+            __m128 o = sigmoid4(_mm_load_ps(a + 3u * G + j));
+
+            __m128 cj = _mm_add_ps(_mm_mul_ps(f, _mm_load_ps(cs + j)), _mm_mul_ps(i, g));
+            _mm_store_ps(cs + j, cj);
+            _mm_store_ps(hs + j, _mm_mul_ps(o, tanh4(cj)));
+        }
+#else
+        for (uint32_t j = 0; j < G; ++j)
+        {
+            float i = sigmoid(a[j]);
+            float f = sigmoid(a[G + j]);
+            float g = fastTanh(a[2u * G + j]);
+            float o = sigmoid(a[3u * G + j]);
+
+            cs[j] = f * cs[j] + i * g;
+            hs[j] = o * fastTanh(cs[j]);
+        }
+#endif
+
+        float y = biasOut + dotProduct(weightOut.data(), hs, G);
+        samples[n] = skip ? y + x : y;
+    }
+}
+
+void NeuralAmp::processGRU(float* samples, int numSamples)
+{
+    const uint32_t G = gateSize;
+    const float* wIH = weightIH.data();
+    const float* bX = biasX.data();
+    float* ah = gatesH.data();
+    float* hs = h.data();
+
+    for (int n = 0; n < numSamples; ++n)
+    {
+        const float x = samples[n];
+
+        // only the recurrent part, r scales it in the n gate; the input part is bX + wIH x
+        gates(ah, biasH.data(), wIH, 0.0f, weightHH.data(), hs, hidden, stride);
+
+        // h = (1 - z) * n + z * h
+#if DKAMP_USE_SSE2
+        const __m128 vx = _mm_set1_ps(x);
+
+        for (uint32_t j = 0; j < G; j += 4u)
+        {
+            __m128 axr = _mm_add_ps(_mm_load_ps(bX + j), _mm_mul_ps(_mm_load_ps(wIH + j), vx));
+            __m128 axz = _mm_add_ps(_mm_load_ps(bX + G + j), _mm_mul_ps(_mm_load_ps(wIH + G + j), vx));
+            __m128 axn = _mm_add_ps(_mm_load_ps(bX + 2u * G + j), _mm_mul_ps(_mm_load_ps(wIH + 2u * G + j), vx));
+
+            __m128 r = sigmoid4(_mm_add_ps(axr, _mm_load_ps(ah + j)));
+            __m128 z = sigmoid4(_mm_add_ps(axz, _mm_load_ps(ah + G + j)));
+            __m128 g = tanh4(_mm_add_ps(axn, _mm_mul_ps(r, _mm_load_ps(ah + 2u * G + j))));
+
+            _mm_store_ps(hs + j, _mm_add_ps(g, _mm_mul_ps(z, _mm_sub_ps(_mm_load_ps(hs + j), g))));
+        }
+#else
+        for (uint32_t j = 0; j < G; ++j)
+        {
+            float r = sigmoid(bX[j] + wIH[j] * x + ah[j]);
+            float z = sigmoid(bX[G + j] + wIH[G + j] * x + ah[G + j]);
+            float g = fastTanh(bX[2u * G + j] + wIH[2u * G + j] * x + r * ah[2u * G + j]);
+
+            hs[j] = g + z * (hs[j] - g);
+        }
+#endif
+
+        float y = biasOut + dotProduct(weightOut.data(), hs, G);
+        samples[n] = skip ? y + x : y;
+    }
+}
@@ -0,0 +1,96 @@
+/*
+  ==============================================================================
+
+    NeuralAmp.h
+    Created: 23 Oct 2026 7:48:20pm
+    Author:  dkuzn
+
+    Small recurrent amp models (one LSTM or GRU layer, 1 in / 1 out, dense
+    output layer, optional skip) as trained by Automated-GuitarAmpModelling
+    and used by GuitarML (Proteus, NeuralPi). The json holds
+        model_data: unit_type ("LSTM" / "GRU"), hidden_size, skip, [sample_rate]
+        state_dict: rec.weight_ih_l0, rec.weight_hh_l0, rec.bias_ih_l0,
+                    rec.bias_hh_l0, lin.weight, lin.bias (PyTorch layout)
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <cstdint>
+#include <vector>
+#include "VectorOps.h"
+
+
+class NeuralAmp
+{
+public:
+    enum class Cell
+    {
+        LSTM, // gates i, f, g, o
+        GRU   // gates r, z, n
+    };
+
+    static constexpr uint32_t maxHidden = 64u;
+
+    // weights in PyTorch layout, rows = gates * hidden
+    struct Model
+    {
+        Cell cell = Cell::LSTM;
+        uint32_t hidden = 0;
+        bool skip = true;
+        double sampleRate = 48000.0;
+
+        std::vector<float> weightIH; // rows x 1
+        std::vector<float> weightHH; // rows x hidden, row major
+        std::vector<float> biasIH;   // rows
+        std::vector<float> biasHH;   // rows
+        std::vector<float> weightOut; // hidden
+        float biasOut = 0.0f;
+
+        uint32_t getRows() const { return hidden * (cell == Cell::LSTM ? 4u : 3u); }
+        bool isValid() const;
+    };
+
+    NeuralAmp();
+
+    // parse + setModel, false (model unchanged) if the file is not a supported model
+    bool loadModel(const juce::File& file);
+    static bool parseModel(const juce::var& json, Model& model);
+
+    // repacks the weights and allocates the state, not for the audio thread
+    bool setModel(const Model& model);
+    void clearModel();
+    bool hasModel() const { return loaded; }
+    double getModelSampleRate() const { return modelSampleRate; }
+
+    void reset();
+    void processBlock(float* samples, int numSamples);
+
+private:
+    void processLSTM(float* samples, int numSamples);
+    void processGRU(float* samples, int numSamples);
+
+    bool loaded = false;
+    Cell cell = Cell::LSTM;
+    uint32_t hidden = 0;
+    uint32_t gateSize = 0; // hidden rounded up to 4, each gate starts on an SSE register
+    uint32_t stride = 0;   // gates * gateSize rows
+    bool skip = true;
+    double modelSampleRate = 48000.0;
+
+    // recurrent weights transposed: column j (weights of h[j] for all gate
+    // rows) is contiguous, W * h keeps a block of gate rows in registers over all j
+    AlignedBuffer weightHH; // hidden x stride
+    AlignedBuffer weightIH; // stride
+    AlignedBuffer biasX;    // LSTM: both biases, GRU: input bias
+    AlignedBuffer biasH;    // GRU only: recurrent bias (n gate applies r to it)
+    AlignedBuffer weightOut; // gateSize
+    float biasOut = 0.0f;
+
+    AlignedBuffer gatesX; // per sample scratch, stride
+    AlignedBuffer gatesH; // per sample scratch, stride
+    AlignedBuffer h; // gateSize
+    AlignedBuffer c; // gateSize
+};
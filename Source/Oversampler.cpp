@@ -0,0 +1,149 @@
+/*
+  ==============================================================================
+
+    Oversampler.cpp
+    Created: 21 Oct 2026 2:15:48pm
+    Author:  dkuzn
+
+  ==============================================================================
+*/
+
+#include "Oversampler.h"
+#include <algorithm>
+#include <cstring>
+
+
+namespace
+{
+    // per stage: FIR side taps / IIR sections and transition width,
+    // all reject the images by 80 dB or more
+    const uint32_t firTaps[3] = { 16u, 8u, 5u };
+    const uint32_t iirCoeffs[3] = { 8u, 4u, 3u };
+    const double iirTransition[3] = { 0.04, 0.2, 0.25 };
+}
+
+
+Oversampler::Oversampler()
+{
+}
+
+void Oversampler::prepare(uint32_t factor, Phase phase, uint32_t maxBlockLength)
+{
+    numStages = 0;
+    while ((1u << numStages) < factor && numStages < maxStages)
+        ++numStages;
+
+    this->factor = 1u << numStages;
+    this->phase = phase;
+
+    firUp.clear();
+    firDown.clear();
+    iirUp.clear();
+    iirDown.clear();
+    buffers.clear();
+
+    for (uint32_t k = 0; k < numStages; ++k)
+    {
+        if (phase == Phase::Linear)
+        {
+            firUp.emplace_back(firTaps[k]);
+            firDown.emplace_back(firTaps[k]);
+        }
+        else
+        {
+            iirUp.emplace_back(iirCoeffs[k], iirTransition[k]);
+            iirDown.emplace_back(iirCoeffs[k], iirTransition[k]);
+        }
+
+        buffers.emplace_back((size_t)maxBlockLength << (k + 1u), 0.0f);
+    }
+
+    // factor 1: the "high rate" buffer is just a copy
+    if (numStages == 0)
+        buffers.emplace_back(maxBlockLength, 0.0f);
+}
+
+void Oversampler::reset()
+{
+    for (auto& f : firUp) f.reset();
+    for (auto& f : firDown) f.reset();
+    for (auto& f : iirUp) f.reset();
+    for (auto& f : iirDown) f.reset();
+}
+
+float* Oversampler::processUp(const float* input, uint32_t numSamples)
+{
+    if (numStages == 0)
+    {
+        std::memcpy(buffers[0].data(), input, numSamples * sizeof(float));
+        return buffers[0].data();
+    }
+
+    const float* src = input;
+    uint32_t length = numSamples;
+
+    for (uint32_t k = 0; k < numStages; ++k)
+    {
+        float* dst = buffers[k].data();
+
+        if (phase == Phase::Linear)
+        {
+            for (uint32_t i = 0; i < length; ++i)
+                firUp[k].interpolate(src[i], dst[2u * i], dst[2u * i + 1u]);
+        }
+        else
+        {
+            for (uint32_t i = 0; i < length; ++i)
+                iirUp[k].interpolate(src[i], dst[2u * i], dst[2u * i + 1u]);
+        }
+
+        src = dst;
+        length *= 2u;
+    }
+
+    return buffers[numStages - 1u].data();
+}
+
+void Oversampler::processDown(float* output, uint32_t numSamples)
+{
+    if (numStages == 0)
+    {
+        std::memcpy(output, buffers[0].data(), numSamples * sizeof(float));
+        return;
+    }
+
+    for (uint32_t k = numStages; k-- > 0;)
+    {
+        const float* src = buffers[k].data();
+        float* dst = (k == 0) ? output : buffers[k - 1u].data();
+        const uint32_t length = numSamples << k; // output length of this stage
+
+        if (phase == Phase::Linear)
+        {
+            for (uint32_t i = 0; i < length; ++i)
+                dst[i] = firDown[k].decimate(src[2u * i], src[2u * i + 1u]);
+        }
+        else
+        {
+            for (uint32_t i = 0; i < length; ++i)
+                dst[i] = iirDown[k].decimate(src[2u * i], src[2u * i + 1u]);
+        }
+    }
+}
+
+double Oversampler::getLatency() const
+{
+    // stage k pair delay is given at its lower rate (2^k times the base rate)
+    double latency = 0.0;
+
+    for (uint32_t k = 0; k < numStages; ++k)
+    {
+        double stageLatency = (phase == Phase::Linear)
+            ? (double)firUp[k].getLatency()
+            : iirUp[k].getLatency();
+
+        latency += stageLatency / (double)(1u << k);
+    }
+
+    return latency;
+}
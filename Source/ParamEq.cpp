@@ -9,7 +9,10 @@
 */
 
 #include "ParamEq.h"
+#include "FastMath.h"
+#include "VectorOps.h"
 #define _USE_MATH_DEFINES
+#include <algorithm>
 #include <cmath>
 #include <vector>
 
@@ -20,6 +23,15 @@ namespace
 }
 #endif
 
+namespace
+{
+    // gain grid of the coefficient tables: [-tableRange, tableRange] dB,
+    // gains outside of it are calculated in place
+    constexpr float tableRange = 12.0f;
+    constexpr float tableStep = 0.1f;
+    constexpr uint32_t tableSize = 241u; // 2 * tableRange / tableStep + 1
+}
+
 Biquad::Biquad()
 {
 
@@ -28,7 +40,42 @@ Biquad::Biquad()
 void Biquad::setParams(Type type, double sampleRate, double freq, double Q, float gainDB)
 {
     this->type = type;
+    rampTo(calculate(type, sampleRate, freq, Q, gainDB), 0);
+}
+
+void Biquad::rampParams(Type type, double sampleRate, double freq, double Q, float gainDB, int steps)
+{
+    this->type = type;
+    rampTo(calculate(type, sampleRate, freq, Q, gainDB), steps);
+}
+
+void Biquad::rampTo(const Coefficients& coefficients, int steps)
+{
+    target = coefficients;
 
+    if (steps <= 1)
+    {
+        rampSteps = 0;
+        b0 = target.b0;
+        b1 = target.b1;
+        b2 = target.b2;
+        a1 = target.a1;
+        a2 = target.a2;
+        return;
+    }
+
+    rampSteps = steps;
+
+    const double scale = 1.0 / steps;
+    delta.b0 = (target.b0 - b0) * scale;
+    delta.b1 = (target.b1 - b1) * scale;
+    delta.b2 = (target.b2 - b2) * scale;
+    delta.a1 = (target.a1 - a1) * scale;
+    delta.a2 = (target.a2 - a2) * scale;
+}
+
+Biquad::Coefficients Biquad::calculate(Type type, double sampleRate, double freq, double Q, float gainDB)
+{
     double A = std::pow(10.0, gainDB / 40.0); // gain linear
     double w0 = 2.0 * M_PI * freq / sampleRate;
     double alpha = std::sin(w0) / (2.0 * Q);
@@ -67,11 +114,7 @@ void Biquad::setParams(Type type, double sampleRate, double freq, double Q, floa
     }
 
     // normalisation
-    this->b0 = b0 / a0;
-    this->b1 = b1 / a0;
-    this->b2 = b2 / a0;
-    this->a1 = a1 / a0;
-    this->a2 = a2 / a0;
+    return { b0 / a0, b1 / a0, b2 / a0, a1 / a0, a2 / a0 };
 }
 
 void Biquad::reset()
@@ -81,43 +124,391 @@ void Biquad::reset()
 
 
 
+template <typename T>
+void BiquadCascade<T>::load(const Biquad& first, const Biquad& second, const Biquad& third)
+{
+    const Biquad* sections[3] = { &first, &second, &third };
+
+    for (int s = 0; s < 3; ++s)
+    {
+        b0[s] = (T)sections[s]->b0;
+        b1[s] = (T)sections[s]->b1;
+        b2[s] = (T)sections[s]->b2;
+        a1[s] = (T)sections[s]->a1;
+        a2[s] = (T)sections[s]->a2;
+        x1[s] = (T)sections[s]->x1;
+        x2[s] = (T)sections[s]->x2;
+        y1[s] = (T)sections[s]->y1;
+        y2[s] = (T)sections[s]->y2;
+    }
+}
+
+template <typename T>
+void BiquadCascade<T>::store(Biquad& first, Biquad& second, Biquad& third) const
+{
+    Biquad* sections[3] = { &first, &second, &third };
+
+    for (int s = 0; s < 3; ++s)
+    {
+        sections[s]->x1 = (double)x1[s];
+        sections[s]->x2 = (double)x2[s];
+        sections[s]->y1 = (double)y1[s];
+        sections[s]->y2 = (double)y2[s];
+    }
+}
+
+// steps t = 2 .. numSamples - 1: lanes [x(t), low(t - 1), mid(t - 2), -] in,
+// [low(t), mid(t - 1), high(t - 2), -] out, so each input is the last output
+// of the lane below
+#if DKAMP_USE_SSE2
+template <>
+void BiquadCascade<float>::processSkewed(float* samples, int numSamples)
+{
+    const __m128 vb0 = _mm_load_ps(b0);
+    const __m128 vb1 = _mm_load_ps(b1);
+    const __m128 vb2 = _mm_load_ps(b2);
+    const __m128 va1 = _mm_load_ps(a1);
+    const __m128 va2 = _mm_load_ps(a2);
+    __m128 vx1 = _mm_load_ps(x1);
+    __m128 vx2 = _mm_load_ps(x2);
+    __m128 vy1 = _mm_load_ps(y1);
+    __m128 vy2 = _mm_load_ps(y2);
+
+    for (int t = 2; t < numSamples; ++t)
+    {
+        __m128 in = _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(vy1), 4));
+        in = _mm_move_ss(in, _mm_set_ss(samples[t]));
+
+        __m128 q = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(vb1, vx1), _mm_mul_ps(vb2, vx2)), _mm_mul_ps(va2, vy2));
+        __m128 y = _mm_add_ps(_mm_mul_ps(vb0, in), _mm_sub_ps(q, _mm_mul_ps(va1, vy1)));
+
+        vx2 = vx1;
+        vx1 = in;
+        vy2 = vy1;
+        vy1 = y;
+
+        samples[t - 2] = _mm_cvtss_f32(_mm_movehl_ps(y, y));
+    }
+
+    _mm_store_ps(x1, vx1);
+    _mm_store_ps(x2, vx2);
+    _mm_store_ps(y1, vy1);
+    _mm_store_ps(y2, vy2);
+}
+
+template <>
+void BiquadCascade<double>::processSkewed(float* samples, int numSamples)
+{
+    // lanes 0, 1 (lo) and 2, 3 (hi)
+    const __m128d b0Lo = _mm_load_pd(b0), b0Hi = _mm_load_pd(b0 + 2);
+    const __m128d b1Lo = _mm_load_pd(b1), b1Hi = _mm_load_pd(b1 + 2);
+    const __m128d b2Lo = _mm_load_pd(b2), b2Hi = _mm_load_pd(b2 + 2);
+    const __m128d a1Lo = _mm_load_pd(a1), a1Hi = _mm_load_pd(a1 + 2);
+    const __m128d a2Lo = _mm_load_pd(a2), a2Hi = _mm_load_pd(a2 + 2);
+    __m128d x1Lo = _mm_load_pd(x1), x1Hi = _mm_load_pd(x1 + 2);
+    __m128d x2Lo = _mm_load_pd(x2), x2Hi = _mm_load_pd(x2 + 2);
+    __m128d y1Lo = _mm_load_pd(y1), y1Hi = _mm_load_pd(y1 + 2);
+    __m128d y2Lo = _mm_load_pd(y2), y2Hi = _mm_load_pd(y2 + 2);
+
+    for (int t = 2; t < numSamples; ++t)
+    {
+        __m128d inLo = _mm_unpacklo_pd(_mm_set_sd((double)samples[t]), y1Lo);
+        __m128d inHi = _mm_shuffle_pd(y1Lo, y1Hi, 1);
+
+        __m128d qLo = _mm_sub_pd(_mm_add_pd(_mm_mul_pd(b1Lo, x1Lo), _mm_mul_pd(b2Lo, x2Lo)), _mm_mul_pd(a2Lo, y2Lo));
+        __m128d qHi = _mm_sub_pd(_mm_add_pd(_mm_mul_pd(b1Hi, x1Hi), _mm_mul_pd(b2Hi, x2Hi)), _mm_mul_pd(a2Hi, y2Hi));
+        __m128d yLo = _mm_add_pd(_mm_mul_pd(b0Lo, inLo), _mm_sub_pd(qLo, _mm_mul_pd(a1Lo, y1Lo)));
+        __m128d yHi = _mm_add_pd(_mm_mul_pd(b0Hi, inHi), _mm_sub_pd(qHi, _mm_mul_pd(a1Hi, y1Hi)));
+
+        x2Lo = x1Lo; x2Hi = x1Hi;
+        x1Lo = inLo; x1Hi = inHi;
+        y2Lo = y1Lo; y2Hi = y1Hi;
+        y1Lo = yLo; y1Hi = yHi;
+
+        samples[t - 2] = (float)_mm_cvtsd_f64(yHi);
+    }
+
+    _mm_store_pd(x1, x1Lo); _mm_store_pd(x1 + 2, x1Hi);
+    _mm_store_pd(x2, x2Lo); _mm_store_pd(x2 + 2, x2Hi);
+    _mm_store_pd(y1, y1Lo); _mm_store_pd(y1 + 2, y1Hi);
+    _mm_store_pd(y2, y2Lo); _mm_store_pd(y2 + 2, y2Hi);
+}
+#else
+template <typename T>
+void BiquadCascade<T>::processSkewed(float* samples, int numSamples)
+{
+    for (int t = 2; t < numSamples; ++t)
+    {
+        const T in[4] = { (T)samples[t], y1[0], y1[1], y1[2] };
+
+        for (int s = 0; s < 4; ++s)
+        {
+            T q = (b1[s] * x1[s] + b2[s] * x2[s]) - a2[s] * y2[s];
+            T y = b0[s] * in[s] + (q - a1[s] * y1[s]);
+
+            x2[s] = x1[s];
+            x1[s] = in[s];
+            y2[s] = y1[s];
+            y1[s] = y;
+        }
+
+        samples[t - 2] = (float)y1[2];
+    }
+}
+#endif
+
+template <typename T>
+void BiquadCascade<T>::process(float* samples, int numSamples)
+{
+    if (numSamples < 3)
+    {
+        for (int i = 0; i < numSamples; ++i)
+            samples[i] = (float)step(2, step(1, step(0, (T)samples[i])));
+        return;
+    }
+
+    // fill: low two samples ahead, mid one
+    T low0 = step(0, (T)samples[0]);
+    step(0, (T)samples[1]);
+    step(1, low0);
+
+    processSkewed(samples, numSamples);
+
+    // drain: y1 holds [low(n - 1), mid(n - 2), high(n - 3)]
+    T lowLast = y1[0];
+    T midLast = y1[1];
+    samples[numSamples - 2] = (float)step(2, midLast);
+    samples[numSamples - 1] = (float)step(2, step(1, lowLast));
+}
+
+template class BiquadCascade<float>;
+template class BiquadCascade<double>;
+
+
+
+SvfFilter::SvfFilter()
+{
+
+}
+
+void SvfFilter::setup(Biquad::Type type, double sampleRate, double freq, double Q)
+{
+    this->type = type;
+    g0 = (float)std::tan(M_PI * freq / sampleRate);
+    k0 = (float)(1.0 / Q);
+}
+
+void SvfFilter::setGain(float gainDB)
+{
+    // same analog prototypes as the RBJ shelf / peak, so the responses match Biquad
+    float sqrtA = fastExp2(gainDB * 0.0415241012f); // 10^(dB / 80)
+    float A = sqrtA * sqrtA;
+    float g = g0;
+    float k = k0;
+
+    if (type == Biquad::LowShelf)
+    {
+        g = g0 / sqrtA;
+        m0 = 1.0f;
+        m1 = k0 * (A - 1.0f);
+        m2 = A * A - 1.0f;
+    }
+    else if (type == Biquad::HighShelf)
+    {
+        g = g0 * sqrtA;
+        m0 = A * A;
+        m1 = k0 * (1.0f - A) * A;
+        m2 = 1.0f - A * A;
+    }
+    else // Peak
+    {
+        k = k0 / A;
+        m0 = 1.0f;
+        m1 = k * (A * A - 1.0f);
+        m2 = 0.0f;
+    }
+
+    a1 = 1.0f / (1.0f + g * (g + k));
+    a2 = g * a1;
+    a3 = g * a2;
+}
+
+void SvfFilter::reset()
+{
+    ic1eq = ic2eq = 0.0f;
+}
+
+
+
 SimpleEQ::SimpleEQ()
 {
 
 }
 
-void SimpleEQ::initialise(double sampleRate, float freqLow, float freqMid, float freqHigh)
+SimpleEQ::~SimpleEQ()
+{
+}
+
+void SimpleEQ::initialise(double sampleRate, float freqLow, float freqMid, float freqHigh, double Q)
 {
     this->sampleRate = sampleRate;
     this->freqLow = freqLow;
     this->freqMid = freqMid;
     this->freqHigh = freqHigh;
+    this->Q = Q;
 
     updateFilters();
+
+    // 3 x 241 coefficient sets, cheap enough to not need a worker thread
+    tables.build([sampleRate, freqLow, freqMid, freqHigh, Q]
+    {
+        return buildTable(sampleRate, freqLow, freqMid, freqHigh, Q);
+    });
+
+    svfLow.setup(Biquad::LowShelf, sampleRate, freqLow, Q);
+    svfMid.setup(Biquad::Peak, sampleRate, freqMid, Q);
+    svfHigh.setup(Biquad::HighShelf, sampleRate, freqHigh, Q);
+    svfLow.setGain(lowGain);
+    svfMid.setGain(midGain);
+    svfHigh.setGain(highGain);
+    svfLowGain = lowGain;
+    svfMidGain = midGain;
+    svfHighGain = highGain;
+}
+
+bool SimpleEQ::isTableReady() const
+{
+    return tables.isReady();
+}
+
+void SimpleEQ::setBackend(Backend backend)
+{
+    this->backend = backend;
+
+    // the other backend did not follow the gains
+    lowChanged = midChanged = highChanged = true;
+
+    if (backend == Backend::Svf)
+        applySvfGains();
+
+    reset();
 }
 
 void SimpleEQ::setLowGain(float dB)
 {
     lowGain = dB;
-    updateFilters();
+    lowChanged = true;
 }
 
 void SimpleEQ::setMidGain(float dB)
 {
     midGain = dB;
-    updateFilters();
+    midChanged = true;
 }
 
 void SimpleEQ::setHighGain(float dB)
 {
     highGain = dB;
-    updateFilters();
+    highChanged = true;
 }
 
 void SimpleEQ::processBlock(float* samples, int numSamples)
 {
+    if (backend == Backend::Svf)
+    {
+        processSvfBlock(samples, numSamples);
+        return;
+    }
+
+    int done = 0;
+
+    while (done < numSamples)
+    {
+        if (controlCountdown <= 0)
+            updateControl();
+
+        float* block = samples + done;
+        int length = numSamples - done;
+
+        if (low.isRamping() || mid.isRamping() || high.isRamping())
+        {
+            // ramps end with the control interval
+            length = std::min(length, controlCountdown);
+
+            for (int i = 0; i < length; ++i)
+                block[i] = processBiquads(block[i]);
+        }
+        else if (precision == Precision::Float)
+        {
+            BiquadCascade<float> cascade;
+            cascade.load(low, mid, high);
+            cascade.process(block, length);
+            cascade.store(low, mid, high);
+        }
+        else
+        {
+            BiquadCascade<double> cascade;
+            cascade.load(low, mid, high);
+            cascade.process(block, length);
+            cascade.store(low, mid, high);
+        }
+
+        controlCountdown -= length;
+        done += length;
+    }
+}
+
+void SimpleEQ::applySvfGains()
+{
+    if (lowChanged)
+        svfLow.setGain(lowGain);
+
+    if (midChanged)
+        svfMid.setGain(midGain);
+
+    if (highChanged)
+        svfHigh.setGain(highGain);
+
+    svfLowGain = lowGain;
+    svfMidGain = midGain;
+    svfHighGain = highGain;
+    lowChanged = midChanged = highChanged = false;
+}
+
+void SimpleEQ::processSvfBlock(float* samples, int numSamples)
+{
+    if (numSamples > 0 && (lowChanged || midChanged || highChanged))
+    {
+        // one setter call per block: the gains glide there over the block
+        const float lowStep = (lowGain - svfLowGain) / numSamples;
+        const float midStep = (midGain - svfMidGain) / numSamples;
+        const float highStep = (highGain - svfHighGain) / numSamples;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float t = (float)(i + 1);
+
+            if (lowChanged)
+                svfLow.setGain(svfLowGain + t * lowStep);
+
+            if (midChanged)
+                svfMid.setGain(svfMidGain + t * midStep);
+
+            if (highChanged)
+                svfHigh.setGain(svfHighGain + t * highStep);
+
+            samples[i] = svfHigh.processSample(svfMid.processSample(svfLow.processSample(samples[i])));
+        }
+
+        svfLowGain = lowGain;
+        svfMidGain = midGain;
+        svfHighGain = highGain;
+        lowChanged = midChanged = highChanged = false;
+        return;
+    }
+
     for (int i = 0; i < numSamples; ++i)
-        samples[i] = processSample(samples[i]);
+        samples[i] = svfHigh.processSample(svfMid.processSample(svfLow.processSample(samples[i])));
 }
 
 void SimpleEQ::reset()
@@ -125,12 +516,78 @@ void SimpleEQ::reset()
     low.reset();
     mid.reset();
     high.reset();
+    svfLow.reset();
+    svfMid.reset();
+    svfHigh.reset();
+}
+
+void SimpleEQ::updateControl()
+{
+    controlCountdown = controlInterval;
+
+    if (!(lowChanged || midChanged || highChanged))
+        return;
+
+    const Table* t = tables.acquire();
+
+    // the ramp ends when the next update may start a new one
+    if (lowChanged)
+        rampBand(low, 0, Biquad::LowShelf, freqLow, lowGain, t);
+
+    if (midChanged)
+        rampBand(mid, 1, Biquad::Peak, freqMid, midGain, t);
+
+    if (highChanged)
+        rampBand(high, 2, Biquad::HighShelf, freqHigh, highGain, t);
+
+    lowChanged = midChanged = highChanged = false;
+}
+
+void SimpleEQ::rampBand(Biquad& filter, int band, Biquad::Type type, float freq, float dB, const Table* t)
+{
+    if (t != nullptr && std::fabs(dB) <= tableRange)
+        filter.rampTo(t->lookup(band, dB), controlInterval);
+    else
+        filter.rampParams(type, sampleRate, freq, Q, dB, controlInterval);
 }
 
 void SimpleEQ::updateFilters()
 {
-    low.setParams(Biquad::LowShelf, sampleRate, freqLow, 0.707, lowGain);
-    mid.setParams(Biquad::Peak, sampleRate, freqMid, 0.707, midGain);
-    high.setParams(Biquad::HighShelf, sampleRate, freqHigh, 0.707, highGain);
+    lowChanged = midChanged = highChanged = false;
+
+    low.setParams(Biquad::LowShelf, sampleRate, freqLow, Q, lowGain);
+    mid.setParams(Biquad::Peak, sampleRate, freqMid, Q, midGain);
+    high.setParams(Biquad::HighShelf, sampleRate, freqHigh, Q, highGain);
+}
+
+SimpleEQ::Table SimpleEQ::buildTable(double sampleRate, float freqLow, float freqMid, float freqHigh, double Q)
+{
+    Table t;
+
+    for (auto& band : t.bands)
+        band.resize(tableSize);
+
+    for (uint32_t i = 0; i < tableSize; ++i)
+    {
+        float dB = -tableRange + i * tableStep;
+        t.bands[0][i] = Biquad::calculate(Biquad::LowShelf, sampleRate, freqLow, Q, dB);
+        t.bands[1][i] = Biquad::calculate(Biquad::Peak, sampleRate, freqMid, Q, dB);
+        t.bands[2][i] = Biquad::calculate(Biquad::HighShelf, sampleRate, freqHigh, Q, dB);
+    }
+
+    return t;
+}
+
+Biquad::Coefficients SimpleEQ::Table::lookup(int band, float dB) const
+{
+    float pos = (dB + tableRange) * (1.0f / tableStep);
+    uint32_t i = std::min((uint32_t)std::max(pos, 0.0f), tableSize - 2u);
+    double frac = (double)(pos - (float)i);
+
+    const Biquad::Coefficients& c0 = bands[band][i];
+    const Biquad::Coefficients& c1 = bands[band][i + 1u];
+
+    return { c0.b0 + frac * (c1.b0 - c0.b0), c0.b1 + frac * (c1.b1 - c0.b1), c0.b2 + frac * (c1.b2 - c0.b2),
+        c0.a1 + frac * (c1.a1 - c0.a1), c0.a2 + frac * (c1.a2 - c0.a2) };
 }
 
@@ -9,18 +9,38 @@
 */
 #pragma once
 
+#include <cstdint>
+#include <vector>
+#include "BackgroundTable.h"
+
 
 class Biquad
 {
 public:
     enum Type { LowShelf, HighShelf, Peak };
 
+    // normalised (a0 = 1)
+    struct Coefficients
+    {
+        double b0, b1, b2, a1, a2;
+    };
+
     Biquad();
 
+    static Coefficients calculate(Type type, double sampleRate, double freq, double Q, float gainDB);
+
     void setParams(Type type, double sampleRate, double freq, double Q, float gainDB);
 
+    // same as setParams, but the coefficients move there linearly over steps samples;
+    // the stable (a1, a2) region is convex, so every step in between is stable too
+    void rampParams(Type type, double sampleRate, double freq, double Q, float gainDB, int steps);
+    void rampTo(const Coefficients& coefficients, int steps);
+
     inline float processSample(float x)
     {
+        if (rampSteps > 0)
+            stepRamp();
+
         double y = b0 * x + b1 * x1 + b2 * x2
             - a1 * y1 - a2 * y2;
 
@@ -35,15 +55,114 @@ public:
 
     void reset();
 
+    bool isRamping() const { return rampSteps > 0; }
+
 private:
+    template <typename T>
+    friend class BiquadCascade;
+
+    inline void stepRamp()
+    {
+        if (--rampSteps == 0)
+        {
+            // land exactly on the target, no accumulated rounding
+            b0 = target.b0; b1 = target.b1; b2 = target.b2;
+            a1 = target.a1; a2 = target.a2;
+            return;
+        }
+
+        b0 += delta.b0; b1 += delta.b1; b2 += delta.b2;
+        a1 += delta.a1; a2 += delta.a2;
+    }
+
     Type type;
     double b0 = 1.0, b1 = 0.0, b2 = 0.0;
     double a1 = 0.0, a2 = 0.0;
 
+    Coefficients target = { 1.0, 0.0, 0.0, 0.0, 0.0 };
+    Coefficients delta = { 0.0, 0.0, 0.0, 0.0, 0.0 };
+    int rampSteps = 0;
+
     double x1 = 0.0, x2 = 0.0;
     double y1 = 0.0, y2 = 0.0;
 };
 
+// Three Biquads in series, packed into vector lanes with a time skew: in
+// each step lane s runs section s on sample n - s, so the three recursions
+// no longer wait for each other. The pipeline is filled and drained per
+// block; the states come from and go back to the Biquads, so blocks and
+// processSample can follow each other. Not for ramping Biquads.
+template <typename T>
+class BiquadCascade
+{
+public:
+    void load(const Biquad& first, const Biquad& second, const Biquad& third);
+    void store(Biquad& first, Biquad& second, Biquad& third) const;
+
+    void process(float* samples, int numSamples);
+
+private:
+    // one section, same operation order as the lanes
+    inline T step(int s, T x)
+    {
+        T q = (b1[s] * x1[s] + b2[s] * x2[s]) - a2[s] * y2[s];
+        T y = b0[s] * x + (q - a1[s] * y1[s]);
+
+        x2[s] = x1[s];
+        x1[s] = x;
+        y2[s] = y1[s];
+        y1[s] = y;
+
+        return y;
+    }
+
+    void processSkewed(float* samples, int numSamples);
+
+    // lane 3 idles (zero coefficients), it only fills the vector
+    alignas(32) T b0[4] = {}, b1[4] = {}, b2[4] = {}, a1[4] = {}, a2[4] = {};
+    alignas(32) T x1[4] = {}, x2[4] = {}, y1[4] = {}, y2[4] = {};
+};
+
+// Trapezoidal (TPT) state variable filter, Simper's form, float state.
+// Shelf and bell are mixes of the input, band and low pass outputs; a gain
+// change only moves g and the mix (no tan), so it can follow every sample
+// and the state stays valid under any modulation.
+class SvfFilter
+{
+public:
+    SvfFilter();
+
+    // tan of the cutoff, not for per sample use
+    void setup(Biquad::Type type, double sampleRate, double freq, double Q);
+
+    // cheap (FastMath exp2 and one division), per sample
+    void setGain(float gainDB);
+
+    inline float processSample(float v0)
+    {
+        float v3 = v0 - ic2eq;
+        float v1 = a1 * ic1eq + a2 * v3;
+        float v2 = ic2eq + a2 * ic1eq + a3 * v3;
+
+        ic1eq = 2.0f * v1 - ic1eq;
+        ic2eq = 2.0f * v2 - ic2eq;
+
+        return m0 * v0 + m1 * v1 + m2 * v2;
+    }
+
+    void reset();
+
+private:
+    Biquad::Type type = Biquad::Peak;
+    float g0 = 0.0f; // tan(pi * freq / sampleRate)
+    float k0 = 1.0f; // 1 / Q
+
+    float a1 = 1.0f, a2 = 0.0f, a3 = 0.0f;
+    float m0 = 1.0f, m1 = 0.0f, m2 = 0.0f;
+
+    float ic1eq = 0.0f, ic2eq = 0.0f;
+};
+
 // ==========================
 // 3-band EQ
 // ==========================
@@ -52,15 +171,75 @@ class SimpleEQ
 {
 public:
 
+    // Biquad: direct form I in double, gains at control rate (tables, ramps)
+    // Svf: TPT state variable filters in float, gains every sample
+    enum class Backend { Biquad, Svf };
+
+    // processBlock kernel of the Biquad backend: Double gives processSample's
+    // results (up to rounding), Float is faster
+    enum class Precision { Double, Float };
+
     SimpleEQ();
+    ~SimpleEQ();
 
-    void initialise(double sampleRate, float freqLow, float freqMid, float freqHigh);
+    SimpleEQ(const SimpleEQ&) = delete;
+    SimpleEQ& operator=(const SimpleEQ&) = delete;
 
+    // sets the filters directly and rebuilds the gain tables (a few tens of us,
+    // on the calling thread - not the audio thread)
+    void initialise(double sampleRate, float freqLow, float freqMid, float freqHigh, double Q = 0.707);
+    bool isTableReady() const;
+
+    void setBackend(Backend backend);
+    Backend getBackend() const { return backend; }
+
+    void setPrecision(Precision precision) { this->precision = precision; }
+
+    // Biquad picks the gains up at control rate: every controlInterval samples
+    // the changed bands are looked up and ramped to over the next interval;
+    // Svf applies them at once in processSample and glides to them over the
+    // block in processBlock
     void setLowGain(float dB);
     void setMidGain(float dB);
     void setHighGain(float dB);
 
+    static constexpr int controlInterval = 32; // samples, 0.7 ms at 48 kHz
+
     inline float processSample(float x)
+    {
+        if (backend == Backend::Svf)
+        {
+            if (lowChanged || midChanged || highChanged)
+                applySvfGains();
+
+            return svfHigh.processSample(svfMid.processSample(svfLow.processSample(x)));
+        }
+
+        if (--controlCountdown <= 0)
+            updateControl();
+
+        return processBiquads(x);
+    }
+
+    // fast path: outside of ramps the Biquad backend runs the BiquadCascade kernel
+    void processBlock(float* samples, int numSamples);
+
+    void reset();
+
+private:
+    // coefficients of the three bands on a uniform dB grid, linear in between
+    struct Table
+    {
+        std::vector<Biquad::Coefficients> bands[3]; // low, mid, high
+
+        Biquad::Coefficients lookup(int band, float dB) const;
+    };
+
+    static Table buildTable(double sampleRate, float freqLow, float freqMid, float freqHigh, double Q);
+
+    void rampBand(Biquad& filter, int band, Biquad::Type type, float freq, float dB, const Table* t);
+
+    inline float processBiquads(float x)
     {
         float y = x;
         y = low.processSample(y);
@@ -69,21 +248,35 @@ public:
         return y;
     }
 
-    void processBlock(float* samples, int numSamples);
-
-    void reset();
+    void applySvfGains();
+    void processSvfBlock(float* samples, int numSamples);
 
-private:
     double sampleRate = 44100.0;
     float freqLow = 200.0f;
     float freqMid = 1000.0f;
     float freqHigh = 8000.0f;
+    double Q = 0.707;
 
     float lowGain = 0.0f;
     float midGain = 0.0f;
     float highGain = 0.0f;
 
+    bool lowChanged = false;
+    bool midChanged = false;
+    bool highChanged = false;
+    int controlCountdown = 0;
+
+    Backend backend = Backend::Biquad;
+    Precision precision = Precision::Double;
+
     Biquad low, mid, high;
+    SvfFilter svfLow, svfMid, svfHigh;
+    float svfLowGain = 0.0f; // gains the SVFs are set to
+    float svfMidGain = 0.0f;
+    float svfHighGain = 0.0f;
 
     void updateFilters();
+    void updateControl();
+
+    BackgroundTable<Table> tables;
 };
@@ -4,6 +4,34 @@
 
 #define LOGGER_ENABLE 0u
 
+// run the whole chain at FIXED_SAMPLE_RATE, resampling at input and output of processBlock
+#define FIXED_RATE_ENABLE 0u
+#define FIXED_SAMPLE_RATE 48000u
+
+// oversampling around the diode clipper: 1 (off), 2, 4 or 8;
+// minimum phase (IIR) half-bands have ~3 samples latency instead of ~31
+#define OVERSAMPLING_FACTOR 2u
+#define OVERSAMPLING_MIN_PHASE 1u
+
+// 12AX7 gain stage (Koren model, table driven) in front of the diode clipper
+#define TRIODE_ENABLE 0u
+
+// LSTM / GRU amp model (NeuralAmp_file) in place of the oversampled triode and clipper;
+// it runs at the process rate and is only used when that matches the model's sample_rate
+// (FIXED_RATE_ENABLE pins the process rate to FIXED_SAMPLE_RATE for 48 kHz models)
+#define NEURAL_AMP_ENABLE 0u
+
+// EQ on TPT state variable filters (float, gains applied every sample)
+// instead of the double precision biquads (gains at control rate)
+#define EQ_SVF_ENABLE 0u
+
+// block kernel of the biquad EQ in float (faster) instead of double
+#define EQ_FLOAT_KERNEL 0u
+
+// leave IR partitions and high bins holding less than 1e-6 of the IR energy
+// (-60 dB) out of the cab convolution; approximate, the default is exact
+#define CAB_SPARSE_ENABLE 0u
+
 const juce::ParameterID gainParamID{ "gain", 1 };
 const juce::ParameterID outputParamID{ "output", 1 };
 const juce::ParameterID eqLowParamID{ "eqLow", 1 };
@@ -70,6 +70,13 @@ DkAmpAudioProcessorEditor::DkAmpAudioProcessorEditor (DkAmpAudioProcessor& p)
     cabGroup.addChildComponent(cabNormButton);
     addAndMakeVisible(cabGroup);
 
+    profileButton.setButtonText("Profile");
+    profileButton.onClick = [this]() {
+        loadProfileFile();
+        };
+    profileButton.setLookAndFeel(ButtonLookAndFeel::get());
+    addAndMakeVisible(profileButton);
+
     addAndMakeVisible(gainKnob);
 
     addAndMakeVisible(outputKnob);
@@ -100,6 +107,7 @@ DkAmpAudioProcessorEditor::~DkAmpAudioProcessorEditor()
     loadButton.setLookAndFeel(nullptr);
     previousButton.setLookAndFeel(nullptr);
     nextButton.setLookAndFeel(nullptr);
+    profileButton.setLookAndFeel(nullptr);
 }
 
 //==============================================================================
@@ -160,6 +168,8 @@ void DkAmpAudioProcessorEditor::resized()
 
     cabEnableButton.setBounds((eqWidth * 0.20) - (buttonWidth / 2), buttonHeight + 25 + 20 + buttonHeight, comboBoxWidth, buttonHeight);
     cabNormButton.setBounds((eqWidth * 0.20) - (buttonWidth / 2), buttonHeight + 25 + 20 + buttonHeight + buttonHeight + 10, comboBoxWidth, buttonHeight);
+
+    profileButton.setBounds((0.15 * width) - (buttonWidth / 2), height - eqHeight - margin + 25, buttonWidth, buttonHeight);
 }
 
 void DkAmpAudioProcessorEditor::loadIRFile()
@@ -185,7 +195,7 @@ void DkAmpAudioProcessorEditor::loadIRFile()
 
             if (chosen.existsAsFile())
             {
-                audioProcessor.cabSim.loadIR(chosen);
+                audioProcessor.loadIR(chosen);
             }
 
             juce::File folder;
@@ -220,6 +230,33 @@ void DkAmpAudioProcessorEditor::loadIRFile()
         });
 }
 
+void DkAmpAudioProcessorEditor::loadProfileFile()
+{
+    auto profilePath = audioProcessor.apvts.state.getProperty("AmpProfile_file").toString();
+    juce::File startLocation = profilePath.isNotEmpty()
+        ? juce::File(profilePath).getParentDirectory()
+        : juce::File::getSpecialLocation(juce::File::userHomeDirectory);
+
+    chooser = std::make_unique<juce::FileChooser>("Select amp profile...",
+        startLocation,
+        "*.dkap");
+
+    auto flags = juce::FileBrowserComponent::openMode
+        | juce::FileBrowserComponent::canSelectFiles;
+
+    chooser->launchAsync(flags, [this](const juce::FileChooser& fc)
+        {
+            auto chosen = fc.getResult();
+            if (!chosen.existsAsFile())
+                return;
+
+            if (audioProcessor.loadAmpProfile(chosen))
+            {
+                audioProcessor.apvts.state.setProperty("AmpProfile_file", chosen.getFullPathName(), nullptr);
+            }
+        });
+}
+
 void DkAmpAudioProcessorEditor::restoreIRFile()
 {
     auto folderPath = audioProcessor.apvts.state.getProperty("IR_folder").toString();
@@ -260,7 +297,7 @@ void DkAmpAudioProcessorEditor::comboBoxChange()
 
             if (selectedFile.existsAsFile())
             {
-                audioProcessor.cabSim.loadIR(selectedFile);
+                audioProcessor.loadIR(selectedFile);
                 audioProcessor.apvts.state.setProperty("IR_file", selectedFile.getFullPathName(), nullptr);
             }
         }
@@ -285,7 +322,7 @@ void DkAmpAudioProcessorEditor::nextIR()
 
             if (selectedFile.existsAsFile())
             {
-                audioProcessor.cabSim.loadIR(selectedFile);
+                audioProcessor.loadIR(selectedFile);
                 audioProcessor.apvts.state.setProperty("IR_file", selectedFile.getFullPathName(), nullptr);
             }
         }
@@ -310,7 +347,7 @@ void DkAmpAudioProcessorEditor::prevIR()
 
             if (selectedFile.existsAsFile())
             {
-                audioProcessor.cabSim.loadIR(selectedFile);
+                audioProcessor.loadIR(selectedFile);
                 audioProcessor.apvts.state.setProperty("IR_file", selectedFile.getFullPathName(), nullptr);
             }
         }
@@ -47,6 +47,7 @@ private:
     juce::TextButton nextButton;
     juce::TextButton cabEnableButton;
     juce::TextButton cabNormButton;
+    juce::TextButton profileButton;
 
 
     juce::AudioProcessorValueTreeState::ButtonAttachment bypassAttachment{
@@ -67,6 +68,7 @@ private:
     juce::GroupComponent eqGroup, cabGroup;
 
     void loadIRFile();
+    void loadProfileFile();
     void restoreIRFile();
     void comboBoxChange();
     void nextIR();
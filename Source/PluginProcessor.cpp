@@ -122,15 +122,91 @@ void DkAmpAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
         this->samplesPerBlock = 64;
     }
 
-    params.prepareToPlay(this->sampleRate);
+    processRate = this->sampleRate;
+    int processBlockLength = this->samplesPerBlock;
+    fixedRateActive = false;
+    double hostLatency = 0.0; // in host rate samples
+
+#if FIXED_RATE_ENABLE
+    if ((uint32_t)this->sampleRate != FIXED_SAMPLE_RATE)
+    {
+        // everything below (tables, IR cache) only ever sees FIXED_SAMPLE_RATE
+        fixedRateActive = true;
+        processRate = (double)FIXED_SAMPLE_RATE;
+
+        inputResampler.prepare((uint32_t)this->sampleRate, FIXED_SAMPLE_RATE);
+        outputResampler.prepare(FIXED_SAMPLE_RATE, (uint32_t)this->sampleRate);
+
+        uint32_t maxInternal = inputResampler.getMaxOutput((uint32_t)this->samplesPerBlock);
+        processBlockLength = (int)maxInternal;
+        internalBuffer.assign(maxInternal, 0.0f);
+
+        // output side is primed with a few samples, so jitter of the produced
+        // sample count never leaves processBlock short of samples
+        const uint32_t prime = 4u;
+        outputFifo.assign(outputResampler.getMaxOutput(maxInternal) + this->samplesPerBlock + prime, 0.0f);
+        outputFifoCount = prime;
+
+        double latency = inputResampler.getLatency() * FIXED_SAMPLE_RATE / this->sampleRate
+            + outputResampler.getLatency();
+        hostLatency += latency * this->sampleRate / FIXED_SAMPLE_RATE + prime;
+    }
+#endif
+
+    stageBuffer.assign(processBlockLength, 0.0f);
+    outputGains.assign(processBlockLength, 0.0f);
+
+#if NEURAL_AMP_ENABLE
+    // neural amp model (.json) replaces the whole nonlinear stage when loaded
+    auto modelPath = apvts.state.getProperty("NeuralAmp_file").toString();
+    neuralAmp.clearModel();
+
+    if (modelPath.isNotEmpty())
+    {
+        juce::File file(modelPath);
+
+        if (file.existsAsFile())
+        {
+            neuralAmp.loadModel(file);
+        }
+    }
+
+    // the recurrent state is tied to the sample rate it was trained at,
+    // a model at any other process rate falls back to the triode / clipper
+    if (neuralAmp.hasModel() && std::abs(neuralAmp.getModelSampleRate() - processRate) > 1.0)
+    {
+        DBG("NeuralAmp: model trained at " << neuralAmp.getModelSampleRate() << " Hz, process rate is " << processRate << " Hz");
+        neuralAmp.clearModel();
+    }
+#endif
+
+    // only the nonlinear stage runs oversampled
+    oversampler.prepare(OVERSAMPLING_FACTOR,
+        OVERSAMPLING_MIN_PHASE ? Oversampler::Phase::Minimum : Oversampler::Phase::Linear,
+        (uint32_t)processBlockLength);
+
+    if (!neuralAmp.hasModel())
+        hostLatency += oversampler.getLatency() * this->sampleRate / processRate;
+
+    chainLatency = hostLatency;
+
+    params.prepareToPlay(processRate);
     params.reset();
     params.update();
 
-    eq.initialise(this->sampleRate, 250.0f, 800.0f, 3000.0f);
+    eq.setBackend(EQ_SVF_ENABLE ? SimpleEQ::Backend::Svf : SimpleEQ::Backend::Biquad);
+    eq.setPrecision(EQ_FLOAT_KERNEL ? SimpleEQ::Precision::Float : SimpleEQ::Precision::Double);
+    eq.initialise(processRate, 250.0f, 800.0f, 3000.0f);
     
     auto filePath = apvts.state.getProperty("IR_file").toString();
 
-    cabSim.init(this->sampleRate, this->samplesPerBlock);
+    // at high host rates the cab runs decimated (never below 44.1 kHz)
+    cabSim.setDecimation(true);
+    cabSim.setSparseErrorBound(CAB_SPARSE_ENABLE ? 1.0e-6f : 0.0f);
+    // max cab latency in samples (0 = half of the block); a state property only,
+    // there is no parameter or UI for it
+    cabSim.setLatencyBudget((uint32_t)juce::jmax(0, (int)apvts.state.getProperty("CabLatency_budget", 0)));
+    cabSim.init(processRate, processBlockLength);
 
     if (filePath.isNotEmpty())
     {
@@ -141,12 +217,58 @@ void DkAmpAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
             cabSim.loadIR(file);
         }
     }
+
+    updateLatency();
     
+#if TRIODE_ENABLE
+    // runs oversampled together with the clipper
+    triode.prepare(processRate * oversampler.getFactor());
+#endif
+
+    // measured amp profile (.dkap) replaces the diode clipper when loaded
+    auto profilePath = apvts.state.getProperty("AmpProfile_file").toString();
+    ampProfile.clearProfile();
+
+    if (profilePath.isNotEmpty())
+    {
+        loadAmpProfile(juce::File(profilePath));
+    }
+
+    ampProfile.prepare(processRate * oversampler.getFactor());
+
+    // memoryless clipper -> lookup table (rebuilt in the background on parameter change)
+    diodeClip.setMode(DiodeClipper::Mode::Table);
     diodeClip.setSeriesResistance(100000.0f); // serier resistance [R]
     diodeClip.setSaturationCurrent(1.0e-9f); // saturation current [A]
     diodeClip.setNVt(25.85e-3); // thermal voltage [V]
 }
 
+void DkAmpAudioProcessor::loadIR(const juce::File& file)
+{
+    cabSim.loadIR(file);
+    updateLatency();
+}
+
+bool DkAmpAudioProcessor::loadAmpProfile(const juce::File& file)
+{
+    juce::MemoryBlock data;
+    AmpProfile profile;
+
+    if (!file.existsAsFile() || !file.loadFileAsData(data) || !profile.parse(data.getData(), data.getSize()))
+        return false;
+
+    // built at the rate of the last prepare(), the audio thread picks it up at the next block
+    ampProfile.setProfile(profile);
+    return true;
+}
+
+void DkAmpAudioProcessor::updateLatency()
+{
+    // the cab runs at the process rate, its partition size depends on the loaded IR
+    double cabLatency = cabSim.getLatency() * this->sampleRate / processRate;
+    setLatencySamples((int)std::lround(chainLatency + cabLatency));
+}
+
 void DkAmpAudioProcessor::releaseResources()
 {
     // When playback stops, you can use this as an opportunity to free up any
@@ -189,18 +311,74 @@ void DkAmpAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::
 
     const float* inputData = buffer.getReadPointer(0);
     float* outputData = buffer.getWritePointer(0);
- 
+    const int numSamples = buffer.getNumSamples();
 
-    for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
+    if (fixedRateActive)
     {
-        params.smoothen();
+        // internal buffers are sized for samplesPerBlock, longer host blocks go in chunks
+        for (int start = 0; start < numSamples; start += this->samplesPerBlock)
+        {
+            const int chunk = std::min(this->samplesPerBlock, numSamples - start);
+
+            uint32_t numInternal = inputResampler.process(inputData + start, (uint32_t)chunk, internalBuffer.data());
+
+            processChain(internalBuffer.data(), internalBuffer.data(), (int)numInternal);
+
+            outputFifoCount += outputResampler.process(internalBuffer.data(), numInternal, &outputFifo[outputFifoCount]);
+
+            uint32_t available = std::min(outputFifoCount, (uint32_t)chunk);
+            std::copy(outputFifo.begin(), outputFifo.begin() + available, outputData + start);
+            std::fill(outputData + start + available, outputData + start + chunk, 0.0f);
+
+            std::copy(outputFifo.begin() + available, outputFifo.begin() + outputFifoCount, outputFifo.begin());
+            outputFifoCount -= available;
+        }
+    }
+    else
+    {
+        processChain(inputData, outputData, numSamples);
+    }
+}
+
+void DkAmpAudioProcessor::processChain(const float* inputData, float* outputData, int numSamples)
+{
+    if (params.bypassed)
+    {
+        for (int sample = 0; sample < numSamples; ++sample)
+        {
+            params.smoothen();
+            outputData[sample] = inputData[sample] * (params.gain / 10.0f);
+        }
+        return;
+    }
+
+    cabSim.setNormalize(params.cabNorm);
 
-        float signal = inputData[sample];
+    // the chain runs in stages over the block, so the clipper can solve many samples at once
+    const int maxChunk = (int)stageBuffer.size();
 
-        signal *= (params.gain / 10.0f);
+    for (int start = 0; start < numSamples; start += maxChunk)
+    {
+        const int chunk = std::min(maxChunk, numSamples - start);
 
-        if (!params.bypassed)
+        // --- gain (smoothed parameters per sample) and EQ (block kernel, gains
+        // handed over once per control interval) ---
+        for (int eqStart = 0; eqStart < chunk; eqStart += SimpleEQ::controlInterval)
         {
+            const int eqLength = std::min(SimpleEQ::controlInterval, chunk - eqStart);
+
+            for (int sample = eqStart; sample < eqStart + eqLength; ++sample)
+            {
+                params.smoothen();
+
+                float signal = inputData[start + sample];
+
+                signal *= (params.gain / 10.0f);
+
+                stageBuffer[sample] = signal;
+                outputGains[sample] = params.output;
+            }
+
             if (params.eqLow != lastEqLow)
             {
                 eq.setLowGain(params.eqLow);
@@ -219,26 +397,34 @@ void DkAmpAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::
                 lastEqHigh = params.eqHigh;
             }
 
-            cabSim.setNormalize(params.cabNorm);
+            eq.processBlock(stageBuffer.data() + eqStart, eqLength);
 
-            signal = eq.processSample(signal);
-
-            // alternative non-linear function
-            //signal = softClipWaveShaper(signal, params.gain);
-
-            // diode clipper
-            signal = diodeClip.process(signal);
-
-            signal = cabSim.process(signal);
-
-            signal *= params.output;
+            // alternative non-linear function (instead of the diode clipper stage)
+            //for (int sample = eqStart; sample < eqStart + eqLength; ++sample)
+            //    stageBuffer[sample] = softClipWaveShaper(stageBuffer[sample], params.gain);
+        }
 
-            outputData[sample] = signal;
+        // --- neural amp model, or triode and diode clipper / amp profile (oversampled) ---
+#if NEURAL_AMP_ENABLE
+        if (neuralAmp.hasModel())
+        {
+            neuralAmp.processBlock(stageBuffer.data(), chunk);
         }
         else
+#endif
         {
-            outputData[sample] = signal;
+            float* oversampled = oversampler.processUp(stageBuffer.data(), (uint32_t)chunk);
+#if TRIODE_ENABLE
+            triode.processBlock(oversampled, chunk * (int)oversampler.getFactor());
+#endif
+            if (!ampProfile.processBlock(oversampled, chunk * (int)oversampler.getFactor()))
+                diodeClip.processBlock(oversampled, chunk * (int)oversampler.getFactor());
+            oversampler.processDown(stageBuffer.data(), (uint32_t)chunk);
         }
+
+        // --- cabinet and output gain ---
+        for (int sample = 0; sample < chunk; ++sample)
+            outputData[start + sample] = cabSim.process(stageBuffer[sample]) * outputGains[sample];
     }
 }
 
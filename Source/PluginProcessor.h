@@ -14,6 +14,9 @@
 #include "ParamEq.h"
 #include "CabSim.h"
 #include "DiodeClipper.h"
+#include "Oversampler.h"
+#include "AmpProfile.h"
+#include "NeuralAmp.h"
 
 
 //==============================================================================
@@ -72,12 +75,43 @@ public:
     Parameters params;
     Convolver cabSim;
 
+    // loads the cab IR and reports the new latency to the host
+    void loadIR(const juce::File& file);
+    // measured amp profile (.dkap) in place of the diode clipper, false if the file is not valid
+    bool loadAmpProfile(const juce::File& file);
+
+    // Newton convergence counters of the diode clipper, any thread; the plugin runs
+    // it in Table mode, so they only count solves made before the table is ready
+    DiodeClipper::Stats getClipperStats() const { return diodeClip.getStats(); }
+    void resetClipperStats() { diodeClip.resetStats(); }
+
 private:
-    double sampleRate;
-    int samplesPerBlock;
+    void processChain(const float* inputData, float* outputData, int numSamples);
+    void updateLatency();
+
+    double sampleRate = 48000.0;
+    int samplesPerBlock = 64;
+    double processRate = 48000.0; // rate of the chain: sampleRate or FIXED_SAMPLE_RATE
+    double chainLatency = 0.0; // host samples, everything except the cab
+
+    // fixed internal rate
+    bool fixedRateActive = false;
+    StreamingResampler inputResampler;
+    StreamingResampler outputResampler;
+    std::vector<float> internalBuffer;
+    std::vector<float> outputFifo;
+    uint32_t outputFifoCount = 0;
+
+    // staged chain: gain/EQ output and per-sample output gain of the current chunk
+    std::vector<float> stageBuffer;
+    std::vector<float> outputGains;
 
     SimpleEQ eq;
+    Oversampler oversampler;
+    TriodeStage triode;
     DiodeClipper diodeClip;
+    AmpProfileStage ampProfile;
+    NeuralAmp neuralAmp;
 
 
     float lastEqLow = 0.0f;
@@ -9,7 +9,247 @@
 */
 
 #include "Preamp.h"
+#include <algorithm>
 
+#ifndef M_PI
+namespace
+{
+    const double M_PI = std::acos(-1.0);
+}
+#endif
 
+namespace
+{
+    // table grid: u (grid drive) from below cutoff to a few volts of positive
+    // grid, w (plate supply) for cathode voltages from -2 V to +16 V
+    constexpr uint32_t tableU = 1025u;
+    constexpr uint32_t tableW = 19u;
+    constexpr double uLow = -12.0;
+    constexpr double uHigh = 6.0;
+    constexpr double vk0Low = -2.0;
+    constexpr double vk0High = 16.0;
 
+    // output coupling: 22 nF into 1 MOhm of the next stage
+    constexpr double couplingHz = 7.2;
+}
 
+TriodeStage::TriodeStage()
+{
+}
+
+void TriodeStage::setTube(const Tube& tube)
+{
+    tube_ = tube;
+}
+
+void TriodeStage::setCircuit(double Bplus, double Rp, double Rk, double Ck)
+{
+    Bplus_ = Bplus;
+    Rp_ = Rp;
+    Rk_ = Rk;
+    Ck_ = Ck;
+}
+
+// E1 = Vpk/Kp * ln(1 + exp(Kp * (1/mu + Vgk / sqrt(Kvb + Vpk^2))))
+// Ip = 2 * E1^Ex / Kg1 for E1 > 0
+double TriodeStage::plateCurrent(const Tube& tube, double Vpk, double Vgk)
+{
+    if (Vpk <= 0.0)
+        return 0.0;
+
+    double x = tube.Kp * (1.0 / tube.mu + Vgk / std::sqrt(tube.Kvb + Vpk * Vpk));
+    double softplus = (x > 30.0) ? x : std::log1p(std::exp(x));
+    double E1 = Vpk / tube.Kp * softplus;
+
+    return (E1 > 0.0) ? 2.0 * std::pow(E1, tube.Ex) / tube.Kg1 : 0.0;
+}
+
+// Ip = plateCurrent(w - (Rp + 1/Gsum) * Ip, u - Ip/Gsum): the right side falls
+// with Ip, so the root is unique in [0, w / (Rp + 1/Gsum)]. Illinois regula falsi.
+double TriodeStage::solvePlateCurrent(double u, double w) const
+{
+    const double Rtot = Rp_ + invGsum;
+
+    auto h = [&](double Ip) { return Ip - plateCurrent(tube_, w - Rtot * Ip, u - Ip * invGsum); };
+
+    double lo = 0.0;
+    double hi = std::max(w, 0.0) / Rtot;
+    double hLo = h(lo);
+    double hHi = h(hi);
+
+    if (hLo >= 0.0)
+        return 0.0;
+
+    int side = 0;
+
+    for (int i = 0; i < 100; ++i)
+    {
+        double Ip = (lo * hHi - hi * hLo) / (hHi - hLo);
+        double hIp = h(Ip);
+
+        if (hIp == 0.0 || hi - lo < 1e-15)
+            return Ip;
+
+        if ((hIp > 0.0) == (hHi > 0.0))
+        {
+            hi = Ip;
+            hHi = hIp;
+            if (side == 1)
+                hLo *= 0.5;
+            side = 1;
+        }
+        else
+        {
+            lo = Ip;
+            hLo = hIp;
+            if (side == -1)
+                hHi *= 0.5;
+            side = -1;
+        }
+    }
+
+    return 0.5 * (lo + hi);
+}
+
+void TriodeStage::prepare(double sampleRate)
+{
+    const double Gk = 1.0 / Rk_;
+    Gc = 2.0 * Ck_ * sampleRate;
+    invGsum = 1.0 / (Gk + Gc);
+
+    // operating point: capacitor open, Vk = Rk * Ip
+    double lo = 0.0;
+    double hi = Bplus_ / (Rp_ + Rk_);
+
+    for (int i = 0; i < 100; ++i)
+    {
+        double Ip = 0.5 * (lo + hi);
+        double f = Ip - plateCurrent(tube_, Bplus_ - (Rp_ + Rk_) * Ip, -Rk_ * Ip);
+        (f > 0.0 ? hi : lo) = Ip;
+    }
+
+    IpQ = 0.5 * (lo + hi);
+    VkQ = Rk_ * IpQ;
+    VpQ = Bplus_ - Rp_ * IpQ;
+
+    // mid-band gain: one sample step response at the operating point
+    // (Gc >> Gk there, the cathode is held by the capacitor)
+    double vk0 = VkQ - IpQ * invGsum;
+    double delta = 1e-3;
+    double dIp = solvePlateCurrent(delta - vk0, Bplus_ - vk0) - solvePlateCurrent(-delta - vk0, Bplus_ - vk0);
+    gain = -Rp_ * dIp / (2.0 * delta);
+
+    jcGain = (float)(2.0 * Gc * invGsum);
+    jcFeedback = jcGain - 1.0f;
+    ipOffset = (float)-IpQ;
+    ipScale = (float)(Rp_ / std::fabs(gain));
+
+    // Ip(u, w) table
+    uMin = (float)uLow;
+    uInvStep = (float)((tableU - 1u) / (uHigh - uLow));
+    wMin = (float)(Bplus_ - vk0High);
+    wInvStep = (float)((tableW - 1u) / (vk0High - vk0Low));
+
+    xJc = (float)(invGsum * uInvStep);
+    xOffset = -uMin * uInvStep;
+    yJc = (float)(invGsum * wInvStep);
+    yOffset = (float)((Bplus_ - wMin) * wInvStep);
+
+    // per node: Ip and the difference to the next node along u
+    table.assign(2u * (size_t)tableU * tableW, 0.0f);
+
+    for (uint32_t iw = 0; iw < tableW; ++iw)
+    {
+        double w = wMin + iw / (double)wInvStep;
+        float* row = &table[2u * (size_t)iw * tableU];
+
+        for (uint32_t iu = 0; iu < tableU; ++iu)
+            row[2u * iu] = (float)solvePlateCurrent(uLow + iu / (double)uInvStep, w);
+
+        for (uint32_t iu = 0; iu + 1u < tableU; ++iu)
+            row[2u * iu + 1u] = row[2u * iu + 2u] - row[2u * iu];
+    }
+
+    hpCoeff = (float)std::exp(-2.0 * M_PI * couplingHz / sampleRate);
+
+    reset();
+}
+
+void TriodeStage::reset()
+{
+    // capacitor at rest: no current, jc = Gc * Vk
+    jc = (float)(Gc * VkQ);
+    hpX1 = 0.0f;
+    hpY1 = 0.0f;
+}
+
+// bilinear, clamped to the grid
+float TriodeStage::processTable(float Vg, float& jc) const
+{
+    float x = Vg * uInvStep - jc * xJc + xOffset;
+    float y = yOffset - jc * yJc;
+
+    x = std::min(std::max(x, 0.0f), (float)(tableU - 1u) - 1e-3f);
+    y = std::min(std::max(y, 0.0f), (float)(tableW - 1u) - 1e-3f);
+
+    uint32_t i = (uint32_t)x;
+    uint32_t j = (uint32_t)y;
+    float fx = x - (float)i;
+    float fy = y - (float)j;
+
+    const float* node0 = &table[2u * ((size_t)j * tableU + i)];
+    const float* node1 = node0 + 2u * tableU;
+
+    float a = node0[0] + fx * node0[1];
+    float b = node1[0] + fx * node1[1];
+    float Ip = a + fy * (b - a);
+
+    jc = jcFeedback * jc + jcGain * Ip;
+
+    // plate swing, inverted back and normalized to unity small-signal gain
+    return (Ip + ipOffset) * ipScale;
+}
+
+float TriodeStage::processExact(float Vg, float& jc) const
+{
+    // same limits as the table (stand-in for grid conduction at positive grid)
+    double vk0 = jc * invGsum;
+    double u = std::min(std::max(Vg - vk0, uLow), uHigh);
+    double w = std::min(std::max(Bplus_ - vk0, Bplus_ - vk0High), Bplus_ - vk0Low);
+    float Ip = (float)solvePlateCurrent(u, w);
+
+    jc = jcFeedback * jc + jcGain * Ip;
+
+    return (Ip + ipOffset) * ipScale;
+}
+
+// output coupling cap: y = hpCoeff * (y1 + x - x1)
+float TriodeStage::process(float Vg)
+{
+    float x = (mode_ == Mode::Table) ? processTable(Vg, jc) : processExact(Vg, jc);
+    float y = hpCoeff * (hpY1 + x - hpX1);
+    hpX1 = x;
+    hpY1 = y;
+
+    return y;
+}
+
+void TriodeStage::processBlock(float* samples, int numSamples)
+{
+    // state in locals, so the recursions stay in registers
+    float state = jc;
+    float x1 = hpX1;
+    float y1 = hpY1;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        float x = (mode_ == Mode::Table) ? processTable(samples[i], state) : processExact(samples[i], state);
+        y1 = hpCoeff * (y1 + x - x1);
+        x1 = x;
+        samples[i] = y1;
+    }
+
+    jc = state;
+    hpX1 = x1;
+    hpY1 = y1;
+}
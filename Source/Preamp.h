@@ -10,6 +10,9 @@
 
 #pragma once
 #include <cmath>
+#include <cstdint>
+#include <vector>
+#include "FastMath.h"
 
 /**
 @sgn
@@ -39,8 +42,113 @@ inline double softClipWaveShaper(double xn, double saturation)
     return sgn(xn) * (1.0 - exp(-fabs(saturation * xn)));
 }
 
+inline float softClipWaveShaper(float xn, float saturation)
+{
+    return std::copysign(1.0f - fastExp(-std::fabs(saturation * xn)), xn);
+}
+
 inline float waveshaper(float x, float a1, float a2, float a3, float a4)
 {
     float x2 = x * x;
     return (a1 * x) + (a2 * x2) + (a3 * x * x2) + (a4 * x2 * x2);
 }
+
+
+// Common cathode triode stage: plate resistor Rp to B+, cathode resistor Rk
+// bypassed by Ck (trapezoidal), plate current from the Koren model.
+// Grid current is not modelled, the grid drive is limited to +6 V instead.
+// Output is the plate voltage swing scaled by 1 / small-signal gain
+// (polarity kept), AC coupled like the next stage input.
+//
+// The only state is the cathode capacitor history, so per sample the plate
+// current is a function of two values: the grid drive u = Vg - Vk0 and the
+// plate supply seen from the cathode w = B+ - Vk0, where Vk0 is the cathode
+// voltage the history alone would give. Table mode interpolates a solved
+// 2D table of Ip(u, w) (bilinear), Exact mode solves every sample.
+// The table lookup sits inside the cathode recursion (jc -> Ip -> jc), so the
+// cost is set by its latency: ~23 ns/sample, about 6x the ~4 ns of a Biquad
+// (bench-triode), not yet comparable to it.
+class TriodeStage
+{
+public:
+    enum class Mode { Exact, Table };
+
+    // Koren parameters, 12AX7 by default
+    struct Tube
+    {
+        double mu = 100.0;
+        double Ex = 1.4;
+        double Kg1 = 1060.0;
+        double Kp = 600.0;
+        double Kvb = 300.0;
+    };
+
+    TriodeStage();
+
+    // circuit values, take effect on next prepare()
+    void setTube(const Tube& tube);
+    void setCircuit(double Bplus, double Rp, double Rk, double Ck);
+
+    // solves the operating point and builds the table (~20 ms, not real-time safe)
+    void prepare(double sampleRate);
+    void reset();
+
+    void setMode(Mode mode) { mode_ = mode; }
+    Mode getMode() const { return mode_; }
+
+    float process(float Vg);
+    void processBlock(float* samples, int numSamples);
+
+    // plate voltage gain at the operating point, cathode fully bypassed
+    double getSmallSignalGain() const { return gain; }
+
+    // Koren plate current [A]
+    static double plateCurrent(const Tube& tube, double Vpk, double Vgk);
+
+private:
+    double solvePlateCurrent(double u, double w) const;
+
+    // one sample, jc is the cathode capacitor history
+    float processTable(float Vg, float& jc) const;
+    float processExact(float Vg, float& jc) const;
+
+    Tube tube_;
+    Mode mode_ = Mode::Table;
+    double Bplus_ = 250.0;
+    double Rp_ = 100000.0;
+    double Rk_ = 1500.0;
+    double Ck_ = 22e-6;
+
+    // discretized cathode network: Vk = (Ip + jc) / Gsum,
+    // next jc = 2 * Gc * Vk - jc = jcFeedback * jc + jcGain * Ip
+    double Gc = 0.0;
+    double invGsum = 0.0;
+    float jcGain = 0.0f;
+    float jcFeedback = 0.0f;
+    double IpQ = 0.0; // operating point
+    double VkQ = 0.0;
+    double VpQ = 0.0;
+    double gain = 1.0;
+    float jc = 0.0f;
+
+    // table of (Ip, next Ip - Ip) pairs over u in [uMin, uMin + (nu - 1) / uInvStep],
+    // w likewise; grid coordinates straight from Vg and jc:
+    // x = Vg * uInvStep - jc * xJc + xOffset, y = yOffset - jc * yJc
+    // (keeps the jc -> Ip -> jc recursion short)
+    std::vector<float> table;
+    float uMin = 0.0f;
+    float uInvStep = 0.0f;
+    float wMin = 0.0f;
+    float wInvStep = 0.0f;
+    float xJc = 0.0f;
+    float xOffset = 0.0f;
+    float yJc = 0.0f;
+    float yOffset = 0.0f;
+    float ipOffset = 0.0f; // -IpQ
+    float ipScale = 0.0f; // Rp / |gain|
+
+    // output coupling cap (one-pole high-pass)
+    float hpCoeff = 0.0f;
+    float hpX1 = 0.0f;
+    float hpY1 = 0.0f;
+};
@@ -9,7 +9,115 @@
 */
 
 #include "Resampler.h"
+#include "VectorOps.h"
+#include "Window.h"
+#include <algorithm>
 #include <cmath>
+#include <map>
+#include <mutex>
+#include <numeric>
+
+#define RESAMPLER_MAX_PHASES 1024u
+#define RESAMPLER_ROLLOFF 0.92
+
+#ifndef M_PI
+namespace
+{
+    const double M_PI = std::acos(-1.0);
+}
+#endif
+
+
+PolyphaseBank::PolyphaseBank(uint32_t numPhases, double cutoff, uint32_t numZeroCrossings, double attenuationDB)
+    : numPhases(numPhases)
+{
+    const double beta = kaiserBeta(attenuationDB);
+    const double halfLength = std::ceil(numZeroCrossings / cutoff);
+
+    tapsPerPhase = 2u * (uint32_t)halfLength;
+    // round up to a multiple of 8 for the SIMD dot product, extra taps fall outside the window
+    tapsPerPhase = (tapsPerPhase + 7u) & ~7u;
+    taps.assign((size_t)numPhases * tapsPerPhase, 0.0f);
+
+    const int first = 1 - (int)(tapsPerPhase / 2u);
+
+    for (uint32_t p = 0; p < numPhases; ++p)
+    {
+        const double frac = (double)p / numPhases;
+        float* phaseTaps = &taps[(size_t)p * tapsPerPhase];
+        double sum = 0.0;
+
+        for (uint32_t m = 0; m < tapsPerPhase; ++m)
+        {
+            // distance between output position and this input sample
+            double d = frac - (double)(first + (int)m);
+            double x = M_PI * cutoff * d;
+            double sinc = (std::fabs(x) < 1e-12) ? 1.0 : std::sin(x) / x;
+            double h = cutoff * sinc * kaiserWindow(d / halfLength, beta);
+
+            phaseTaps[m] = (float)h;
+            sum += h;
+        }
+
+        // unity DC gain for every phase
+        for (uint32_t m = 0; m < tapsPerPhase; ++m)
+            phaseTaps[m] = (float)(phaseTaps[m] / sum);
+    }
+}
+
+
+namespace
+{
+    // one output sample: taps applied around input sample i, zeros outside of the signal
+    inline float filterAt(const float* src, uint32_t srcLength, int64_t i, const float* taps, uint32_t numTaps)
+    {
+        int64_t start = i + 1 - (int64_t)(numTaps / 2u);
+
+        if (start >= 0 && start + numTaps <= srcLength)
+            return dotProduct(taps, src + start, numTaps);
+
+        float sum = 0.0f;
+        for (uint32_t m = 0; m < numTaps; ++m)
+        {
+            int64_t idx = start + m;
+            if (idx >= 0 && idx < (int64_t)srcLength)
+                sum += taps[m] * src[idx];
+        }
+        return sum;
+    }
+}
+
+void Resampler::getRatio(uint32_t srcSampleRate, uint32_t dstSampleRate, uint32_t& L, uint32_t& M)
+{
+    uint32_t g = std::gcd(srcSampleRate, dstSampleRate);
+    L = dstSampleRate / g;
+    M = srcSampleRate / g;
+}
+
+std::shared_ptr<const PolyphaseBank> Resampler::getBank(uint32_t srcSampleRate, uint32_t dstSampleRate)
+{
+    static std::mutex lock;
+    static std::map<std::pair<uint32_t, uint32_t>, std::shared_ptr<const PolyphaseBank>> banks;
+
+    std::lock_guard<std::mutex> sl(lock);
+
+    auto key = std::make_pair(srcSampleRate, dstSampleRate);
+    auto it = banks.find(key);
+    if (it != banks.end())
+        return it->second;
+
+    uint32_t L, M;
+    getRatio(srcSampleRate, dstSampleRate, L, M);
+
+    // downsampling: cutoff moves down to the output Nyquist
+    double cutoff = RESAMPLER_ROLLOFF * std::min(1.0, (double)L / (double)M);
+    uint32_t numPhases = (L <= RESAMPLER_MAX_PHASES) ? L : RESAMPLER_MAX_PHASES;
+
+    auto bank = std::make_shared<const PolyphaseBank>(numPhases, cutoff);
+    banks[key] = bank;
+    return bank;
+}
+
 
 void Resampler::resample(uint32_t srcSampleRate,
     uint32_t dstSampleRate,
@@ -24,33 +132,162 @@ void Resampler::resample(uint32_t srcSampleRate,
     if (srcSampleRate == 0 || dstSampleRate == 0 || src == nullptr || srcLength == 0)
         return;
 
-    // wspczynnik zmiany dugoci
-    double ratio = static_cast<double>(dstSampleRate) / static_cast<double>(srcSampleRate);
-
     // nowa dugo
-    dstLength = static_cast<uint32_t>(std::ceil(srcLength * ratio));
+    dstLength = getResampledLength(srcSampleRate, dstSampleRate, srcLength);
 
     // alokacja pamici na wynik
     dst = new float[dstLength];
 
-    for (uint32_t i = 0; i < dstLength; ++i)
+    resampleInto(srcSampleRate, dstSampleRate, src, srcLength, dst, dstLength);
+}
+
+uint32_t Resampler::getResampledLength(uint32_t srcSampleRate, uint32_t dstSampleRate, uint32_t srcLength)
+{
+    if (srcSampleRate == 0 || dstSampleRate == 0)
+        return 0;
+
+    uint32_t L, M;
+    getRatio(srcSampleRate, dstSampleRate, L, M);
+
+    return static_cast<uint32_t>(((uint64_t)srcLength * L + M - 1u) / M);
+}
+
+uint32_t Resampler::resampleInto(uint32_t srcSampleRate,
+    uint32_t dstSampleRate,
+    const float* src,
+    uint32_t srcLength,
+    float* dst,
+    uint32_t dstCapacity)
+{
+    if (srcSampleRate == 0 || dstSampleRate == 0 || src == nullptr || srcLength == 0 || dst == nullptr)
+        return 0;
+
+    uint32_t L, M;
+    getRatio(srcSampleRate, dstSampleRate, L, M);
+
+    uint32_t dstLength = getResampledLength(srcSampleRate, dstSampleRate, srcLength);
+    if (dstLength > dstCapacity)
+        return 0;
+
+    auto bank = getBank(srcSampleRate, dstSampleRate);
+    const uint32_t numTaps = bank->tapsPerPhase;
+
+    if (bank->numPhases == L)
+    {
+        // exact rational ratio: output n lies at input position n * M / L
+        uint64_t pos = 0;
+        for (uint32_t n = 0; n < dstLength; ++n, pos += M)
+        {
+            int64_t i = (int64_t)(pos / L);
+            uint32_t phase = (uint32_t)(pos % L);
+            dst[n] = filterAt(src, srcLength, i, bank->getPhase(phase), numTaps);
+        }
+    }
+    else
     {
-        // pozycja w sygnale rdowym
-        double srcIndex = static_cast<double>(i) / ratio;
+        // no small L/M: interpolate between two nearest phases
+        const double step = (double)M / (double)L;
+        const uint32_t numPhases = bank->numPhases;
 
-        // indeks cakowity
-        uint32_t idx = static_cast<uint32_t>(srcIndex);
+        for (uint32_t n = 0; n < dstLength; ++n)
+        {
+            double srcIndex = n * step;
+            int64_t i = (int64_t)srcIndex;
+            double phasePos = (srcIndex - (double)i) * numPhases;
+            uint32_t phase = (uint32_t)phasePos;
+            float frac = (float)(phasePos - phase);
+
+            float y0 = filterAt(src, srcLength, i, bank->getPhase(phase), numTaps);
+            float y1 = (phase + 1u < numPhases)
+                ? filterAt(src, srcLength, i, bank->getPhase(phase + 1u), numTaps)
+                : filterAt(src, srcLength, i + 1, bank->getPhase(0), numTaps);
+
+            dst[n] = y0 + frac * (y1 - y0);
+        }
+    }
+
+    return dstLength;
+}
+
+StreamingResampler::StreamingResampler()
+{
+}
+
+void StreamingResampler::prepare(uint32_t srcSampleRate, uint32_t dstSampleRate)
+{
+    Resampler::getRatio(srcSampleRate, dstSampleRate, L, M);
+    bank = Resampler::getBank(srcSampleRate, dstSampleRate);
+    exact = (bank->numPhases == L);
 
-        if (idx + 1 < srcLength)
+    windowLength = bank->tapsPerPhase + 1u;
+    history.assign(2u * windowLength, 0.0f);
+
+    reset();
+}
+
+void StreamingResampler::reset()
+{
+    std::fill(history.begin(), history.end(), 0.0f);
+    historyPos = 0;
+    phase = 0;
+    position = 0.0;
+}
+
+uint32_t StreamingResampler::getMaxOutput(uint32_t numInput) const
+{
+    return static_cast<uint32_t>(((uint64_t)numInput * L) / M) + 2u;
+}
+
+double StreamingResampler::getLatency() const
+{
+    return 0.5 * (windowLength - 1u) + 1.0;
+}
+
+// taps of one phase over the window; offset 1 = window one sample later
+float StreamingResampler::filter(uint32_t phaseIndex, uint32_t offset) const
+{
+    return dotProduct(bank->getPhase(phaseIndex), &history[historyPos + offset], bank->tapsPerPhase);
+}
+
+uint32_t StreamingResampler::process(const float* input, uint32_t numInput, float* output)
+{
+    uint32_t numOutput = 0;
+
+    for (uint32_t n = 0; n < numInput; ++n)
+    {
+        history[historyPos] = history[historyPos + windowLength] = input[n];
+        historyPos = (historyPos + 1u == windowLength) ? 0u : historyPos + 1u;
+
+        // outputs lying between the center of the window and the next input sample
+        if (exact)
         {
-            // interpolacja liniowa
-            double frac = srcIndex - idx;
-            dst[i] = static_cast<float>((1.0 - frac) * src[idx] + frac * src[idx + 1]);
+            while (phase < L)
+            {
+                output[numOutput++] = filter(phase, 0u);
+                phase += M;
+            }
+            phase -= L;
         }
         else
         {
-            // ostatnia prbka
-            dst[i] = src[srcLength - 1];
+            const double step = (double)M / (double)L;
+            const uint32_t numPhases = bank->numPhases;
+
+            while (position < 1.0)
+            {
+                double phasePos = position * numPhases;
+                uint32_t p = (uint32_t)phasePos;
+                float frac = (float)(phasePos - p);
+
+                float y0 = filter(p, 0u);
+                float y1 = (p + 1u < numPhases) ? filter(p + 1u, 0u) : filter(0u, 1u);
+
+                output[numOutput++] = y0 + frac * (y1 - y0);
+                position += step;
+            }
+            position -= 1.0;
         }
     }
+
+    return numOutput;
 }
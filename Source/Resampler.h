@@ -10,6 +10,26 @@
 
 #pragma once
 #include <cstdint>
+#include <memory>
+#include <vector>
+
+
+// Polyphase windowed-sinc (Kaiser) filter bank.
+// Phase p holds the taps for an output sample lying p / numPhases of a sample
+// after input sample i; they apply to x[i - tapsPerPhase / 2 + 1 .. i + tapsPerPhase / 2].
+class PolyphaseBank
+{
+public:
+    // cutoff: -6 dB point relative to the input Nyquist (already scaled down for downsampling)
+    // numZeroCrossings: sinc zero crossings on each side at cutoff = 1
+    PolyphaseBank(uint32_t numPhases, double cutoff, uint32_t numZeroCrossings = 32u, double attenuationDB = 90.0);
+
+    const float* getPhase(uint32_t phase) const { return &taps[phase * tapsPerPhase]; }
+
+    uint32_t numPhases = 0;
+    uint32_t tapsPerPhase = 0;
+    std::vector<float> taps;
+};
 
 class Resampler
 {
@@ -22,5 +42,57 @@ public:
         uint32_t srcLength,
         float*& dst,
         uint32_t& dstLength);
+
+    // Resamples into caller provided storage (e.g. an AlignedBuffer), no allocation.
+    // Returns number of samples written: getResampledLength() or 0 if dstCapacity is too small.
+    static uint32_t resampleInto(uint32_t srcSampleRate,
+        uint32_t dstSampleRate,
+        const float* src,
+        uint32_t srcLength,
+        float* dst,
+        uint32_t dstCapacity);
+
+    static uint32_t getResampledLength(uint32_t srcSampleRate, uint32_t dstSampleRate, uint32_t srcLength);
+
+    // Ratio dst/src reduced to L/M. Ratios with L <= RESAMPLER_MAX_PHASES
+    // (e.g. 160/147 for 44.1 -> 48 kHz) get one bank phase per output position
+    // and are exact; the others interpolate between RESAMPLER_MAX_PHASES phases.
+    static void getRatio(uint32_t srcSampleRate, uint32_t dstSampleRate, uint32_t& L, uint32_t& M);
+
+    // Filter banks are designed once per rate pair and shared
+    static std::shared_ptr<const PolyphaseBank> getBank(uint32_t srcSampleRate, uint32_t dstSampleRate);
+};
+
+// Real-time polyphase resampler for a continuous stream (same banks as Resampler).
+// Number of output samples per call varies by one around numInput * dstRate / srcRate.
+class StreamingResampler
+{
+public:
+    StreamingResampler();
+
+    // allocates, call before processing
+    void prepare(uint32_t srcSampleRate, uint32_t dstSampleRate);
+    void reset();
+
+    // returns number of samples written to output (at most getMaxOutput(numInput))
+    uint32_t process(const float* input, uint32_t numInput, float* output);
+
+    uint32_t getMaxOutput(uint32_t numInput) const;
+
+    // delay in input samples
+    double getLatency() const;
+
+private:
+    float filter(uint32_t phase, uint32_t offset) const;
+
+    std::shared_ptr<const PolyphaseBank> bank;
+    uint32_t L = 1;
+    uint32_t M = 1;
+    bool exact = true;
+    uint32_t windowLength = 0; // tapsPerPhase + 1, so the window can be used one sample later too
+    std::vector<float> history; // doubled ring of the last windowLength inputs
+    uint32_t historyPos = 0;
+    uint32_t phase = 0; // exact mode: next output position, in 1/L of input sample
+    double position = 0.0; // other ratios: next output position, in input samples
 };
 
@@ -0,0 +1,114 @@
+/*
+  ==============================================================================
+
+    VectorOps.h
+    Created: 19 Oct 2026 2:21:45pm
+    Author:  dkuzn
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define DKAMP_USE_SSE 1
+#else
+#define DKAMP_USE_SSE 0
+#endif
+
+// SSE2 (double lanes, integer ops), always there on x64
+#if DKAMP_USE_SSE && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define DKAMP_USE_SSE2 1
+#else
+#define DKAMP_USE_SSE2 0
+#endif
+
+/**
+@dotProduct
+\ingroup Vector-Functions
+
+@brief calculates sum of a[i] * b[i]
+\param a - first vector
+\param b - second vector
+\param length - number of elements
+\return the dot product
+*/
+inline float dotProduct(const float* a, const float* b, uint32_t length)
+{
+    uint32_t i = 0;
+    float sum = 0.0f;
+
+#if DKAMP_USE_SSE
+    // two accumulators to hide the add latency
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+
+    for (; i + 8u <= length; i += 8u)
+    {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4u), _mm_loadu_ps(b + i + 4u)));
+    }
+
+    acc0 = _mm_add_ps(acc0, acc1);
+
+    float lanes[4];
+    _mm_storeu_ps(lanes, acc0);
+    sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#else
+    float acc[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+    for (; i + 4u <= length; i += 4u)
+    {
+        acc[0] += a[i] * b[i];
+        acc[1] += a[i + 1u] * b[i + 1u];
+        acc[2] += a[i + 2u] * b[i + 2u];
+        acc[3] += a[i + 3u] * b[i + 3u];
+    }
+
+    sum = (acc[0] + acc[1]) + (acc[2] + acc[3]);
+#endif
+
+    for (; i < length; ++i)
+        sum += a[i] * b[i];
+
+    return sum;
+}
+
+// Float storage aligned to 32 bytes (AVX), reallocated only when it has to grow
+class AlignedBuffer
+{
+public:
+    static constexpr size_t alignment = 32u;
+
+    AlignedBuffer() {}
+    AlignedBuffer(const AlignedBuffer&) = delete;
+    AlignedBuffer& operator=(const AlignedBuffer&) = delete;
+
+    // keeps old content only if no reallocation was needed
+    void resize(size_t numElements)
+    {
+        if (numElements > capacity)
+        {
+            raw.reset(new uint8_t[numElements * sizeof(float) + alignment]);
+            uintptr_t address = reinterpret_cast<uintptr_t>(raw.get());
+            aligned = reinterpret_cast<float*>((address + alignment - 1u) & ~(uintptr_t)(alignment - 1u));
+            capacity = numElements;
+        }
+        numUsed = numElements;
+    }
+
+    float* data() { return aligned; }
+    const float* data() const { return aligned; }
+    size_t size() const { return numUsed; }
+
+private:
+    std::unique_ptr<uint8_t[]> raw;
+    float* aligned = nullptr;
+    size_t capacity = 0;
+    size_t numUsed = 0;
+};
@@ -0,0 +1,71 @@
+/*
+  ==============================================================================
+
+    Window.h
+    Created: 19 Oct 2026 11:02:17am
+    Author:  dkuzn
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <cmath>
+
+/**
+@besselI0
+\ingroup Filter-Design
+
+@brief zeroth order modified Bessel function of the first kind (series expansion)
+\param x - the input value
+\return I0(x)
+*/
+inline double besselI0(double x)
+{
+    double sum = 1.0;
+    double term = 1.0;
+    double halfX = 0.5 * x;
+
+    for (int k = 1; k < 50; ++k)
+    {
+        term *= (halfX / k) * (halfX / k);
+        sum += term;
+        if (term < sum * 1e-12)
+            break;
+    }
+
+    return sum;
+}
+
+/**
+@kaiserWindow
+\ingroup Filter-Design
+
+@brief calculates Kaiser window value
+\param pos - position in the window, -1..1 (0 = center)
+\param beta - shape parameter
+\return window value, 0 outside of the window
+*/
+inline double kaiserWindow(double pos, double beta)
+{
+    if (pos <= -1.0 || pos >= 1.0)
+        return 0.0;
+
+    return besselI0(beta * std::sqrt(1.0 - pos * pos)) / besselI0(beta);
+}
+
+/**
+@kaiserBeta
+\ingroup Filter-Design
+
+@brief Kaiser's formula for beta giving required stopband attenuation
+\param attenuationDB - stopband attenuation in dB (positive)
+\return beta
+*/
+inline double kaiserBeta(double attenuationDB)
+{
+    if (attenuationDB > 50.0)
+        return 0.1102 * (attenuationDB - 8.7);
+    if (attenuationDB >= 21.0)
+        return 0.5842 * std::pow(attenuationDB - 21.0, 0.4) + 0.07886 * (attenuationDB - 21.0);
+    return 0.0;
+}
@@ -0,0 +1,54 @@
+/*
+  ==============================================================================
+
+    AudioFile.cpp
+    Created: 23 Oct 2026 5:02:38pm
+    Author:  dkuzn
+
+  ==============================================================================
+*/
+
+#include "AudioFile.h"
+
+
+juce::File fileFromArgument(const char* path)
+{
+    return juce::File::getCurrentWorkingDirectory().getChildFile(juce::String(path));
+}
+
+bool readWav(const juce::File& file, std::vector<float>& samples, double& sampleRate)
+{
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+
+    std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
+    if (reader == nullptr || reader->lengthInSamples <= 0 || reader->lengthInSamples > (1 << 30))
+        return false;
+
+    juce::AudioBuffer<float> buffer(1, (int)reader->lengthInSamples);
+    if (!reader->read(&buffer, 0, (int)reader->lengthInSamples, 0, true, false))
+        return false;
+
+    samples.assign(buffer.getReadPointer(0), buffer.getReadPointer(0) + buffer.getNumSamples());
+    sampleRate = reader->sampleRate;
+    return true;
+}
+
+bool writeWav(const juce::File& file, const std::vector<float>& samples, double sampleRate)
+{
+    file.deleteFile();
+
+    std::unique_ptr<juce::OutputStream> stream(file.createOutputStream());
+    if (stream == nullptr)
+        return false;
+
+    juce::WavAudioFormat wav;
+    std::unique_ptr<juce::AudioFormatWriter> writer(wav.createWriterFor(stream.get(), sampleRate, 1u, 24, juce::StringPairArray(), 0));
+    if (writer == nullptr)
+        return false;
+
+    stream.release(); // owned by the writer
+
+    const float* channels[] = { samples.data() };
+    return writer->writeFromFloatArrays(channels, 1, (int)samples.size());
+}
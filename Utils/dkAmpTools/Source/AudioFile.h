@@ -0,0 +1,25 @@
+/*
+  ==============================================================================
+
+    AudioFile.h
+    Created: 23 Oct 2026 5:02:38pm
+    Author:  dkuzn
+
+    Mono WAV helpers of the capture tools.
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <vector>
+
+
+// relative paths are taken from the working directory
+juce::File fileFromArgument(const char* path);
+
+// any format JUCE reads, first channel only
+bool readWav(const juce::File& file, std::vector<float>& samples, double& sampleRate);
+
+// 24 bit mono WAV, replaces an existing file
+bool writeWav(const juce::File& file, const std::vector<float>& samples, double sampleRate);
@@ -0,0 +1,297 @@
+/*
+  ==============================================================================
+
+    ClipperBench.cpp
+    Created: 21 Oct 2026 9:40:12am
+    Author:  dkuzn
+
+  ==============================================================================
+*/
+
+#include "ClipperBench.h"
+#include "../../../Source/DiodeClipper.h"
+#include "../../../Source/Oversampler.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#ifndef M_PI
+namespace
+{
+    const double M_PI = std::acos(-1.0);
+}
+#endif
+
+
+namespace
+{
+    const double sampleRate = 48000.0;
+    const uint32_t analysisLength = 65536u;
+    const uint32_t toneBin = 2731u; // ~2 kHz, prime -> harmonics and aliases never share a bin
+    const uint32_t warmupLength = 8192u;
+    const uint32_t timingLength = 1u << 20;
+    const float driveLevels[2] = { 1.0f, 8.0f }; // peak Vin [V]
+
+    // double precision FFT, the plugin FFT runs in float and its noise floor
+    // (around -79 dB) would hide the aliases of the better modes
+    void fftDouble(std::vector<std::complex<double>>& x)
+    {
+        const size_t n = x.size();
+
+        for (size_t i = 1, j = 0; i < n; ++i)
+        {
+            size_t bit = n >> 1;
+            for (; j & bit; bit >>= 1)
+                j ^= bit;
+            j ^= bit;
+
+            if (i < j)
+                std::swap(x[i], x[j]);
+        }
+
+        for (size_t len = 2; len <= n; len <<= 1)
+        {
+            for (size_t k = 0; k < len / 2; ++k)
+            {
+                std::complex<double> w = std::polar(1.0, -2.0 * M_PI * k / len);
+
+                for (size_t i = 0; i < n; i += len)
+                {
+                    std::complex<double> u = x[i + k];
+                    std::complex<double> v = x[i + k + len / 2] * w;
+                    x[i + k] = u + v;
+                    x[i + k + len / 2] = u - v;
+                }
+            }
+        }
+    }
+
+    // Tone sits exactly on a bin, so its harmonics do too (rectangular window is exact).
+    // Everything outside the harmonic bins and DC counts as aliasing.
+    double measureAliasDB(const std::vector<float>& y)
+    {
+        std::vector<std::complex<double>> spectrum(y.begin(), y.end());
+        fftDouble(spectrum);
+
+        double harmonicPower = 0.0;
+        double otherPower = 0.0;
+
+        for (uint32_t k = 1; k <= analysisLength / 2u; ++k)
+        {
+            double p = std::norm(spectrum[k]);
+
+            if (k % toneBin == 0)
+                harmonicPower += p;
+            else
+                otherPower += p;
+        }
+
+        return 10.0 * std::log10(otherPower / harmonicPower + 1e-30);
+    }
+
+    float toneSample(uint32_t n, float drive)
+    {
+        return drive * (float)std::sin(2.0 * M_PI * toneBin * (double)n / analysisLength);
+    }
+
+    const uint32_t blockLength = 64u;
+
+    using BlockProcess = std::function<void(float*, uint32_t)>;
+
+    ClipperReport measure(const char* name, const std::function<BlockProcess()>& create)
+    {
+        ClipperReport report;
+        report.name = name;
+
+        for (int d = 0; d < 2; ++d)
+        {
+            auto process = create();
+            std::vector<float> y(warmupLength + analysisLength);
+
+            for (uint32_t n = 0; n < (uint32_t)y.size(); ++n)
+                y[n] = toneSample(n, driveLevels[d]);
+
+            for (uint32_t start = 0; start < (uint32_t)y.size(); start += blockLength)
+                process(&y[start], blockLength);
+
+            report.aliasDB[d] = measureAliasDB(std::vector<float>(y.begin() + warmupLength, y.end()));
+        }
+
+        std::vector<float> signal(timingLength);
+        for (uint32_t n = 0; n < timingLength; ++n)
+            signal[n] = toneSample(n, driveLevels[1]);
+
+        auto process = create();
+
+        auto start = std::chrono::steady_clock::now();
+        for (uint32_t n = 0; n < timingLength; n += blockLength)
+            process(&signal[n], blockLength);
+        auto end = std::chrono::steady_clock::now();
+
+        report.nsPerSample = std::chrono::duration<double, std::nano>(end - start).count() / timingLength;
+
+        if (signal[timingLength / 2u] == 12345.0f)
+            std::printf(" ");
+
+        return report;
+    }
+
+    void prepareClipper(DiodeClipper& clipper, DiodeClipper::Mode mode)
+    {
+        // same settings as the plugin
+        clipper.setMode(mode);
+        clipper.setSeriesResistance(100000.0f);
+        clipper.setSaturationCurrent(1.0e-9f);
+        clipper.setNVt(25.85e-3f);
+
+        while (mode != DiodeClipper::Mode::Exact && !clipper.isTableReady())
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    // Newton telemetry of the exact solvers on a tone sweeping up to 32 V peak:
+    // mean iterations per input level octave, for the scalar and the block solver
+    void printConvergence()
+    {
+        std::vector<float> signal(analysisLength);
+        for (uint32_t n = 0; n < analysisLength; ++n)
+            signal[n] = toneSample(n, 32.0f * (float)n / analysisLength);
+
+        DiodeClipper scalar;
+        prepareClipper(scalar, DiodeClipper::Mode::Exact);
+        for (float x : signal)
+            scalar.process(x);
+
+        DiodeClipper block;
+        prepareClipper(block, DiodeClipper::Mode::Exact);
+        for (uint32_t start = 0; start < analysisLength; start += blockLength)
+            block.processBlock(&signal[start], blockLength);
+
+        const DiodeClipper::Stats stats[2] = { scalar.getStats(), block.getStats() };
+
+        std::printf("\nexact solve, mean Newton iterations per |Vin| octave\n\n");
+        std::printf("%-12s %10s %10s\n", "|Vin| [V]", "scalar", "block");
+
+        for (int i = 0; i < DiodeClipper::kLevelBins; ++i)
+        {
+            double upper = std::ldexp(1.0, i - 4);
+            if (i == DiodeClipper::kLevelBins - 1)
+                std::printf(">= %-9g", upper / 2.0);
+            else
+                std::printf("< %-10g", upper);
+
+            for (const auto& st : stats)
+            {
+                if (st.levelSamples[i] != 0)
+                    std::printf(" %10.2f", (double)st.levelIterations[i] / st.levelSamples[i]);
+                else
+                    std::printf(" %10s", "-");
+            }
+            std::printf("\n");
+        }
+
+        for (const auto& st : stats)
+        {
+            std::printf("%s: %llu samples, %.2f iterations mean, %llu maxIter hits, %llu tanh fallbacks\n",
+                (&st == &stats[0]) ? "scalar" : "block ",
+                (unsigned long long)st.samples, (double)st.iterations / std::max<uint64_t>(st.samples, 1u),
+                (unsigned long long)st.maxIterHits, (unsigned long long)st.fallbacks);
+        }
+
+        // silence (and denormals) must land in the lowest level bin; process()
+        // publishes every 512 samples, so the length is a multiple of that
+        const uint32_t silenceLength = 1024u;
+        std::vector<float> silence(silenceLength, 0.0f);
+        silence[1] = 1.0e-40f;
+        silence[2] = -1.0e-40f;
+
+        scalar.resetStats();
+        block.resetStats();
+        for (float x : silence)
+            scalar.process(x);
+        for (uint32_t start = 0; start < silenceLength; start += blockLength)
+            block.processBlock(&silence[start], blockLength);
+
+        const DiodeClipper::Stats quiet[2] = { scalar.getStats(), block.getStats() };
+        bool quietOk = true;
+        for (const auto& st : quiet)
+            quietOk = quietOk && st.samples == silenceLength && st.levelSamples[0] == silenceLength;
+
+        std::printf("silent input counted below 1/16 V: %s\n", quietOk ? "ok" : "FAIL");
+    }
+}
+
+
+int runClipperBench()
+{
+    std::vector<ClipperReport> reports;
+
+    const DiodeClipper::Mode modes[] = { DiodeClipper::Mode::Table, DiodeClipper::Mode::Adaa1, DiodeClipper::Mode::Adaa2 };
+    const char* modeNames[] = { "table", "ADAA1", "ADAA2" };
+
+    for (int m = 0; m < 3; ++m)
+    {
+        DiodeClipper clipper;
+        prepareClipper(clipper, modes[m]);
+
+        reports.push_back(measure(modeNames[m], [&clipper, mode = modes[m]]()
+        {
+            clipper.setMode(mode); // resets the ADAA history
+            return [&clipper](float* samples, uint32_t numSamples) { clipper.processBlock(samples, (int)numSamples); };
+        }));
+    }
+
+    const char* oversampledNames[2][3] = { { "lin 2x", "lin 4x", "lin 8x" }, { "min 2x", "min 4x", "min 8x" } };
+    const Oversampler::Phase phases[2] = { Oversampler::Phase::Linear, Oversampler::Phase::Minimum };
+
+    for (int p = 0; p < 2; ++p)
+    {
+        for (uint32_t stages = 1; stages <= 3u; ++stages)
+        {
+            DiodeClipper clipper;
+            prepareClipper(clipper, DiodeClipper::Mode::Table);
+
+            Oversampler oversampler;
+
+            reports.push_back(measure(oversampledNames[p][stages - 1u], [&clipper, &oversampler, phase = phases[p], stages]()
+            {
+                oversampler.prepare(1u << stages, phase, blockLength);
+
+                return [&clipper, &oversampler](float* samples, uint32_t numSamples)
+                {
+                    float* up = oversampler.processUp(samples, numSamples);
+                    clipper.processBlock(up, (int)(numSamples * oversampler.getFactor()));
+                    oversampler.processDown(samples, numSamples);
+                };
+            }));
+        }
+    }
+
+    std::printf("tone %.0f Hz at %.0f Hz, alias = non-harmonic power relative to harmonics\n\n",
+        toneBin * sampleRate / analysisLength, sampleRate);
+    std::printf("%-10s %14s %14s %10s %16s\n", "mode", "alias@1V [dB]", "alias@8V [dB]", "ns/sample", "dB gain per ns");
+
+    const ClipperReport& base = reports[0];
+
+    for (const auto& r : reports)
+    {
+        double suppression = base.aliasDB[1] - r.aliasDB[1];
+        double extraCost = r.nsPerSample - base.nsPerSample;
+
+        std::printf("%-10s %14.1f %14.1f %10.1f", r.name, r.aliasDB[0], r.aliasDB[1], r.nsPerSample);
+
+        if (&r != &base && extraCost > 0.0)
+            std::printf(" %16.2f\n", suppression / extraCost);
+        else
+            std::printf(" %16s\n", "-");
+    }
+
+    printConvergence();
+
+    return 0;
+}
@@ -0,0 +1,24 @@
+/*
+  ==============================================================================
+
+    ClipperBench.h
+    Created: 21 Oct 2026 9:40:12am
+    Author:  dkuzn
+
+  ==============================================================================
+*/
+
+#pragma once
+
+
+struct ClipperReport
+{
+    const char* name = "";
+    double aliasDB[2] = {}; // power of non-harmonic components relative to the harmonics, per drive level
+    double nsPerSample = 0.0;
+};
+
+// Alias suppression and cost of the diode clipper modes (table, ADAA1, ADAA2)
+// against 2x / 4x / 8x oversampling (Oversampler, both phase variants) of the table clipper,
+// then the Newton convergence statistics of the exact solvers per input level
+int runClipperBench();
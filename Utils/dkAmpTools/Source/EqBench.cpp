@@ -0,0 +1,243 @@
+/*
+  ==============================================================================
+
+    EqBench.cpp
+    Created: 24 Oct 2026 10:12:37am
+    Author:  dkuzn
+
+  ==============================================================================
+*/
+
+#include "EqBench.h"
+#include "../../../Source/ParamEq.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#ifndef M_PI
+namespace
+{
+    const double M_PI = std::acos(-1.0);
+}
+#endif
+
+
+namespace
+{
+    // the bands and Q of the plugin
+    const double sampleRate = 48000.0;
+    const float freqLow = 250.0f;
+    const float freqMid = 800.0f;
+    const float freqHigh = 3000.0f;
+    const uint32_t impulseLength = 16384u;
+    const uint32_t length = 1u << 20;
+
+    const float gainSets[][3] = {
+        { 12.0f, 12.0f, 12.0f },
+        { -12.0f, -12.0f, -12.0f },
+        { 6.0f, -9.0f, 3.0f },
+        { -3.0f, 12.0f, -12.0f },
+    };
+
+    enum class Automation { Fixed, Sweep, Lfo };
+
+    void prepare(SimpleEQ& eq, SimpleEQ::Backend backend, const float* gains)
+    {
+        eq.setBackend(backend);
+        eq.setLowGain(gains[0]);
+        eq.setMidGain(gains[1]);
+        eq.setHighGain(gains[2]);
+        eq.initialise(sampleRate, freqLow, freqMid, freqHigh);
+        eq.reset();
+
+        // control rate lookups use the tables as in the plugin
+        while (!eq.isTableReady())
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    std::vector<float> impulseResponse(SimpleEQ::Backend backend, const float* gains)
+    {
+        SimpleEQ eq;
+        prepare(eq, backend, gains);
+
+        std::vector<float> h(impulseLength, 0.0f);
+        h[0] = 1.0f;
+        for (float& v : h)
+            v = eq.processSample(v);
+        return h;
+    }
+
+    // all three gains move every sample: Sweep as the smoothed knobs deliver
+    // it (-12 .. 12 dB in 50 ms), Lfo +-12 dB at 50 Hz (fast modulation)
+    float automatedGain(Automation automation, uint32_t i, int band)
+    {
+        if (automation == Automation::Sweep)
+        {
+            const uint32_t period = (uint32_t)(0.1 * sampleRate);
+            float phase = (float)((i + band * period / 3u) % period) / period;
+            return 12.0f - 48.0f * std::fabs(phase - 0.5f);
+        }
+
+        return 12.0f * (float)std::sin(2.0 * M_PI * (50.0 * i / sampleRate + band / 3.0));
+    }
+
+    std::vector<float> testSignal()
+    {
+        std::vector<float> x(length);
+        for (uint32_t i = 0; i < length; ++i)
+        {
+            x[i] = (float)(0.1 * std::sin(2.0 * M_PI * 100.0 * i / sampleRate)
+                + 0.1 * std::sin(2.0 * M_PI * 800.0 * i / sampleRate)
+                + 0.1 * std::sin(2.0 * M_PI * 3000.0 * i / sampleRate));
+        }
+        return x;
+    }
+
+    // fixed gains, processBlock in blocks of blockSize (0: processSample);
+    // returns the best ns per sample of a few passes, output in x
+    double runBlocks(SimpleEQ::Precision precision, uint32_t blockSize, std::vector<float>& x)
+    {
+        double best = 1e30;
+
+        for (int pass = 0; pass < 5; ++pass)
+        {
+            SimpleEQ eq;
+            prepare(eq, SimpleEQ::Backend::Biquad, gainSets[2]);
+            eq.setPrecision(precision);
+            x = testSignal();
+
+            auto start = std::chrono::steady_clock::now();
+
+            if (blockSize == 0u)
+            {
+                for (uint32_t i = 0; i < length; ++i)
+                    x[i] = eq.processSample(x[i]);
+            }
+            else
+            {
+                for (uint32_t i = 0; i < length; i += blockSize)
+                    eq.processBlock(x.data() + i, (int)std::min(blockSize, length - i));
+            }
+
+            auto end = std::chrono::steady_clock::now();
+            best = std::min(best, std::chrono::duration<double, std::nano>(end - start).count() / length);
+        }
+
+        return best;
+    }
+
+    // input: 100 Hz, 800 Hz and 3 kHz tones; returns ns per sample, output in x
+    double run(SimpleEQ::Backend backend, Automation automation, std::vector<float>& x)
+    {
+        // fixed: 6 / -9 / 3 dB, automated ones start at 0 dB
+        const float flat[3] = { 0.0f, 0.0f, 0.0f };
+        SimpleEQ eq;
+        prepare(eq, backend, automation == Automation::Fixed ? gainSets[2] : flat);
+
+        x = testSignal();
+
+        // the gain curves are precomputed, only the setters are timed
+        std::vector<float> g[3];
+        if (automation != Automation::Fixed)
+        {
+            for (int band = 0; band < 3; ++band)
+            {
+                g[band].resize(length);
+                for (uint32_t i = 0; i < length; ++i)
+                    g[band][i] = automatedGain(automation, i, band);
+            }
+        }
+
+        auto start = std::chrono::steady_clock::now();
+
+        if (automation == Automation::Fixed)
+        {
+            for (uint32_t i = 0; i < length; ++i)
+                x[i] = eq.processSample(x[i]);
+        }
+        else
+        {
+            for (uint32_t i = 0; i < length; ++i)
+            {
+                eq.setLowGain(g[0][i]);
+                eq.setMidGain(g[1][i]);
+                eq.setHighGain(g[2][i]);
+                x[i] = eq.processSample(x[i]);
+            }
+        }
+
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::nano>(end - start).count() / length;
+    }
+}
+
+
+int runEqBench()
+{
+    std::printf("3-band EQ %.0f / %.0f / %.0f Hz, Q 0.707 at %.0f Hz\n\n", freqLow, freqMid, freqHigh, sampleRate);
+    std::printf("%-22s %18s\n", "gains [dB]", "max |h_bq - h_svf|");
+
+    for (const auto& gains : gainSets)
+    {
+        std::vector<float> a = impulseResponse(SimpleEQ::Backend::Biquad, gains);
+        std::vector<float> b = impulseResponse(SimpleEQ::Backend::Svf, gains);
+
+        double maxError = 0.0;
+        for (uint32_t i = 0; i < impulseLength; ++i)
+            maxError = std::max(maxError, (double)std::fabs(a[i] - b[i]));
+
+        char label[48];
+        std::snprintf(label, sizeof(label), "%g / %g / %g", gains[0], gains[1], gains[2]);
+        std::printf("%-22s %18.3g\n", label, maxError);
+    }
+
+    const char* names[] = { "fixed gains", "knob sweeps", "50 Hz LFO" };
+    const Automation automations[] = { Automation::Fixed, Automation::Sweep, Automation::Lfo };
+
+    // the difference under automation is mostly the control rate lag of Biquad
+    std::printf("\n%-14s %16s %16s %18s\n", "", "Biquad ns/sample", "Svf ns/sample", "max |y_bq - y_svf|");
+
+    for (int i = 0; i < 3; ++i)
+    {
+        std::vector<float> a, b;
+        double bq = run(SimpleEQ::Backend::Biquad, automations[i], a);
+        double svf = run(SimpleEQ::Backend::Svf, automations[i], b);
+
+        double maxError = 0.0;
+        for (uint32_t n = 0; n < length; ++n)
+            maxError = std::max(maxError, (double)std::fabs(a[n] - b[n]));
+
+        std::printf("%-14s %16.1f %16.1f %18.3g\n", names[i], bq, svf, maxError);
+    }
+
+    // Biquad backend, fixed gains: skewed lane kernel against the sample loop
+    std::vector<float> reference;
+    double sampleNs = runBlocks(SimpleEQ::Precision::Double, 0u, reference);
+
+    std::printf("\n%-22s %10s %18s\n", "Biquad backend", "ns/sample", "max |y - y_sample|");
+    std::printf("%-22s %10.1f %18s\n", "processSample", sampleNs, "-");
+
+    const uint32_t blockSizes[] = { 32u, 512u };
+    for (uint32_t blockSize : blockSizes)
+    {
+        for (int p = 0; p < 2; ++p)
+        {
+            const SimpleEQ::Precision precision = p ? SimpleEQ::Precision::Float : SimpleEQ::Precision::Double;
+            std::vector<float> y;
+            double ns = runBlocks(precision, blockSize, y);
+
+            double maxError = 0.0;
+            for (uint32_t n = 0; n < length; ++n)
+                maxError = std::max(maxError, (double)std::fabs(y[n] - reference[n]));
+
+            char label[48];
+            std::snprintf(label, sizeof(label), "processBlock %u %s", blockSize, p ? "float" : "double");
+            std::printf("%-22s %10.1f %18.3g\n", label, ns, maxError);
+        }
+    }
+
+    return 0;
+}
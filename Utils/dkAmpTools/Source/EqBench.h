@@ -0,0 +1,17 @@
+/*
+  ==============================================================================
+
+    EqBench.h
+    Created: 24 Oct 2026 10:12:37am
+    Author:  dkuzn
+
+  ==============================================================================
+*/
+
+#pragma once
+
+
+// SimpleEQ backends: Biquad and Svf impulse responses against each other,
+// cost per sample with fixed gains and under automation, block kernels
+// against the sample loop
+int runEqBench();
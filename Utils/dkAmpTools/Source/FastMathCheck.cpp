@@ -0,0 +1,131 @@
+/*
+  ==============================================================================
+
+    FastMathCheck.cpp
+    Created: 22 Oct 2026 10:05:37am
+    Author:  dkuzn
+
+  ==============================================================================
+*/
+
+#include "FastMathCheck.h"
+#include "../../../Source/FastMath.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+
+namespace
+{
+    const uint32_t gridSize = 2000001u;
+
+    enum class ErrorType { Absolute, Relative, AbsolutePlusUlp };
+
+    using BlockFunction = void (*)(const float*, float*, uint32_t);
+
+    struct Check
+    {
+        const char* name;
+        float (*fast)(float);
+        double (*reference)(double);
+        BlockFunction fastBlock; // timed as blocks, the way the DSP code calls them
+        BlockFunction libmBlock; // same loop with the float libm call
+        float from, to;
+        ErrorType type;
+        double bound;
+    };
+
+    double errorOf(const Check& c, float x)
+    {
+        double ref = c.reference(x);
+        double err = std::fabs((double)c.fast(x) - ref);
+
+        if (c.type == ErrorType::Relative)
+            return err / std::fabs(ref);
+
+        if (c.type == ErrorType::AbsolutePlusUlp)
+        {
+            // part of the error is only the float rounding of the result
+            float r = (float)ref;
+            double ulp = std::nextafter(std::fabs(r), INFINITY) - std::fabs(r);
+            return std::max(0.0, err - ulp);
+        }
+
+        return err;
+    }
+
+    double nsPerValue(BlockFunction f, float from, float to)
+    {
+        std::vector<float> x(1024u);
+        for (size_t i = 0; i < x.size(); ++i)
+            x[i] = from + (to - from) * (float)i / (float)x.size();
+
+        std::vector<float> y(x.size());
+        const int repeats = 4096;
+
+        auto start = std::chrono::steady_clock::now();
+        for (int rep = 0; rep < repeats; ++rep)
+            f(x.data(), y.data(), (uint32_t)x.size());
+        auto end = std::chrono::steady_clock::now();
+
+        if (y[y.size() / 2u] == 12345.0f)
+            std::printf(" ");
+
+        return std::chrono::duration<double, std::nano>(end - start).count() / ((double)repeats * x.size());
+    }
+
+    #define DKAMP_LIBM_BLOCK(call) [](const float* x, float* y, uint32_t n) { for (uint32_t i = 0; i < n; ++i) y[i] = call; }
+
+    double pow10Ref(double x) { return std::pow(10.0, x); }
+    float pow10Fast(float x) { return fastPow(10.0f, x); }
+}
+
+
+int runFastMathCheck()
+{
+    const Check checks[] =
+    {
+        { "exp",   fastExp,   [](double x) { return std::exp(x); },  fastExp,  DKAMP_LIBM_BLOCK(std::exp(x[i])),  -87.0f, 88.0f,   ErrorType::Relative, 3e-7 },
+        { "exp2",  fastExp2,  [](double x) { return std::exp2(x); }, fastExp2, DKAMP_LIBM_BLOCK(std::exp2(x[i])), -126.0f, 127.0f, ErrorType::Relative, 3e-7 },
+        { "log",   fastLog,   [](double x) { return std::log(x); },  fastLog,  DKAMP_LIBM_BLOCK(std::log(x[i])),  1e-30f, 1e30f,   ErrorType::AbsolutePlusUlp, 2e-7 },
+        { "log2",  fastLog2,  [](double x) { return std::log2(x); }, fastLog2, DKAMP_LIBM_BLOCK(std::log2(x[i])), 1e-30f, 1e30f,   ErrorType::AbsolutePlusUlp, 3e-7 },
+        { "pow10", pow10Fast, pow10Ref, DKAMP_LIBM_BLOCK(fastPow(10.0f, x[i])), DKAMP_LIBM_BLOCK(std::pow(10.0f, x[i])), -3.0f, 3.0f, ErrorType::Relative, 3e-7 * (1.0 + 3.0 * 3.33) },
+        { "sinh",  fastSinh,  [](double x) { return std::sinh(x); }, fastSinh, DKAMP_LIBM_BLOCK(std::sinh(x[i])), -87.0f, 87.0f,   ErrorType::Relative, 4e-7 },
+        { "cosh",  fastCosh,  [](double x) { return std::cosh(x); }, fastCosh, DKAMP_LIBM_BLOCK(std::cosh(x[i])), -87.0f, 87.0f,   ErrorType::Relative, 4e-7 },
+        { "tanh",  fastTanh,  [](double x) { return std::tanh(x); }, fastTanh, DKAMP_LIBM_BLOCK(std::tanh(x[i])), -30.0f, 30.0f,   ErrorType::Absolute, 2e-7 },
+        { "sin",   fastSin,   [](double x) { return std::sin(x); },  fastSin,  DKAMP_LIBM_BLOCK(std::sin(x[i])),  -8192.0f, 8192.0f, ErrorType::Absolute, 2e-7 },
+        { "cos",   fastCos,   [](double x) { return std::cos(x); },  fastCos,  DKAMP_LIBM_BLOCK(std::cos(x[i])),  -8192.0f, 8192.0f, ErrorType::Absolute, 2e-7 },
+    };
+
+    std::printf("%-6s %24s %12s %12s %10s %10s  %s\n", "func", "range", "max error", "bound", "libm [ns]", "fast [ns]", "result");
+
+    int failures = 0;
+
+    for (const auto& c : checks)
+    {
+        double maxError = 0.0;
+        bool logGrid = (c.from > 0.0f);
+
+        for (uint32_t i = 0; i < gridSize; ++i)
+        {
+            double t = (double)i / (gridSize - 1u);
+            float x = logGrid
+                ? (float)(c.from * std::pow((double)c.to / c.from, t))
+                : (float)(c.from + (c.to - c.from) * t);
+
+            maxError = std::max(maxError, errorOf(c, x));
+        }
+
+        bool pass = maxError <= c.bound;
+        failures += pass ? 0 : 1;
+
+        char range[64];
+        std::snprintf(range, sizeof(range), "[%g, %g]", c.from, c.to);
+
+        std::printf("%-6s %24s %12.3g %12.3g %10.2f %10.2f  %s\n", c.name, range, maxError, c.bound,
+            nsPerValue(c.libmBlock, c.from, c.to), nsPerValue(c.fastBlock, c.from, c.to), pass ? "ok" : "FAIL");
+    }
+
+    return failures == 0 ? 0 : 1;
+}
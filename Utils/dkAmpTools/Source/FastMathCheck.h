@@ -0,0 +1,17 @@
+/*
+  ==============================================================================
+
+    FastMathCheck.h
+    Created: 22 Oct 2026 10:05:37am
+    Author:  dkuzn
+
+  ==============================================================================
+*/
+
+#pragma once
+
+
+// Compares every FastMath.h function against libm (double) on a dense grid,
+// prints the max error next to the documented bound and the speedup.
+// Returns 0 when all functions stay within their bounds.
+int runFastMathCheck();
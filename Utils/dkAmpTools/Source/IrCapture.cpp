@@ -0,0 +1,249 @@
+/*
+  ==============================================================================
+
+    IrCapture.cpp
+    Created: 23 Oct 2026 5:02:38pm
+    Author:  dkuzn
+
+  ==============================================================================
+*/
+
+#include "IrCapture.h"
+#include "AudioFile.h"
+#include "../../../Source/FFT.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#ifndef M_PI
+namespace
+{
+    const double M_PI = std::acos(-1.0);
+}
+#endif
+
+
+namespace
+{
+    const double sweepStartHz = 20.0;
+    const double sweepStopHz = 20000.0;
+    const double sweepLevel = 0.5; // -6 dBFS
+    const double tailSeconds = 1.0; // silence after the sweep for the decay
+    const double leadSeconds = 5.0; // max. delay of the sweep in the recording
+    const double preRollMs = 1.0; // kept before the IR peak
+    const double regularization = 1.0e-5; // of the peak sweep power, -50 dB
+    const double decayLimit = 1.0e-6; // remaining energy at the cut, -60 dB
+    const float peakLevel = 0.891f; // -1 dBFS
+
+    std::vector<float> makeSweep(double sampleRate, double seconds)
+    {
+        const double f0 = sweepStartHz;
+        const double f1 = std::min(sweepStopHz, 0.45 * sampleRate);
+        const double k = std::log(f1 / f0);
+        const uint32_t length = (uint32_t)(seconds * sampleRate);
+
+        std::vector<float> x(length + (uint32_t)(tailSeconds * sampleRate), 0.0f);
+        for (uint32_t i = 0; i < length; ++i)
+        {
+            double t = i / sampleRate;
+            double fade = std::min(1.0, std::min(t, seconds - t) / 0.01); // 10 ms fades
+            x[i] = (float)(sweepLevel * fade * std::sin(2.0 * M_PI * f0 * seconds / k * (std::exp(t / seconds * k) - 1.0)));
+        }
+        return x;
+    }
+
+    // 1 inside the sweep range, cosine tapers over the octave below and the 10 % above it
+    float bandWeight(double hz, double f0, double f1)
+    {
+        if (hz <= 0.5 * f0 || hz >= 1.1 * f1)
+            return 0.0f;
+        if (hz < f0)
+            return (float)(0.5 - 0.5 * std::cos(M_PI * (hz - 0.5 * f0) / (0.5 * f0)));
+        if (hz > f1)
+            return (float)(0.5 + 0.5 * std::cos(M_PI * (hz - f1) / (0.1 * f1)));
+        return 1.0f;
+    }
+
+    // recording / sweep in the frequency domain, circular IR of fftSize samples
+    std::vector<float> deconvolve(const std::vector<float>& recording, const std::vector<float>& sweep, double sampleRate)
+    {
+        FFT fft;
+        const uint32_t fftSize = fft.calculateFFTWindow((uint32_t)std::max(recording.size(), sweep.size()));
+        const uint32_t bins = fftSize / 2u + 1u;
+
+        std::vector<float> yRe(fftSize, 0.0f), yIm(bins);
+        std::vector<float> xRe(fftSize, 0.0f), xIm(bins);
+        std::copy(recording.begin(), recording.end(), yRe.begin());
+        std::copy(sweep.begin(), sweep.end(), xRe.begin());
+
+        fft.realFFT(yRe.data(), yIm.data(), fftSize);
+        fft.realFFT(xRe.data(), xIm.data(), fftSize);
+
+        float maxPower = 0.0f;
+        for (uint32_t k = 0; k < bins; ++k)
+            maxPower = std::max(maxPower, xRe[k] * xRe[k] + xIm[k] * xIm[k]);
+
+        // H = Y conj(X) / (|X|^2 + eps), band limited to the sweep: DC offset,
+        // rumble and hiss of the recording outside of it would spread over the IR
+        const float eps = (float)regularization * maxPower;
+        const double f0 = sweepStartHz;
+        const double f1 = std::min(sweepStopHz, 0.45 * sampleRate);
+
+        for (uint32_t k = 0; k < bins; ++k)
+        {
+            float w = bandWeight(k * sampleRate / fftSize, f0, f1);
+            float power = xRe[k] * xRe[k] + xIm[k] * xIm[k] + eps;
+            float re = w * (yRe[k] * xRe[k] + yIm[k] * xIm[k]) / power;
+            float im = w * (yIm[k] * xRe[k] - yRe[k] * xIm[k]) / power;
+            yRe[k] = re;
+            yIm[k] = im;
+        }
+
+        fft.realIFFT(yRe.data(), yIm.data(), fftSize);
+        return yRe;
+    }
+
+    // from preRoll before the peak to the -60 dB point of the decay (at most maxLength), faded, normalized
+    std::vector<float> cutIR(const std::vector<float>& h, double sampleRate, uint32_t maxLength, uint32_t& peak)
+    {
+        const uint32_t size = (uint32_t)h.size(); // power of 2, circular
+        const uint32_t preRoll = std::max(1u, (uint32_t)(preRollMs * 0.001 * sampleRate));
+
+        peak = 0;
+        for (uint32_t i = 1; i < size; ++i)
+        {
+            if (std::fabs(h[i]) > std::fabs(h[peak]))
+                peak = i;
+        }
+
+        maxLength = std::min(maxLength, size);
+        std::vector<float> ir(maxLength);
+        for (uint32_t i = 0; i < maxLength; ++i)
+            ir[i] = h[(peak - preRoll + i) & (size - 1u)];
+
+        // backward integrated energy (Schroeder), cut where the rest is below decayLimit
+        std::vector<double> rest(maxLength + 1u, 0.0);
+        for (uint32_t i = maxLength; i-- > 0;)
+            rest[i] = rest[i + 1u] + (double)ir[i] * ir[i];
+
+        uint32_t length = std::min(maxLength, preRoll + (uint32_t)(0.01 * sampleRate)); // at least 10 ms after the peak
+        while (length < maxLength && rest[length] > decayLimit * rest[0])
+            ++length;
+
+        ir.resize(length);
+
+        // raised cosine in over the pre-roll, half Hann out over the last 10 %
+        const uint32_t fadeOut = std::min(length, std::max(64u, length / 10u));
+        for (uint32_t i = 0; i < preRoll && i < length; ++i)
+            ir[i] *= (float)(0.5 - 0.5 * std::cos(M_PI * i / preRoll));
+        for (uint32_t i = 0; i < fadeOut; ++i)
+            ir[length - 1u - i] *= (float)(0.5 - 0.5 * std::cos(M_PI * i / fadeOut));
+
+        float max = 0.0f;
+        for (float v : ir)
+            max = std::max(max, std::fabs(v));
+
+        if (max > 0.0f)
+        {
+            for (float& v : ir)
+                v *= peakLevel / max;
+        }
+
+        return ir;
+    }
+}
+
+
+int runGenSweep(int argc, char* argv[])
+{
+    if (argc < 1)
+    {
+        std::printf("Use: dkAmpTools gen-sweep <out.wav> [sampleRate=48000] [seconds=10]\n");
+        return 1;
+    }
+
+    const double sampleRate = (argc > 1) ? std::atof(argv[1]) : 48000.0;
+    const double seconds = (argc > 2) ? std::atof(argv[2]) : 10.0;
+
+    if (sampleRate < 22050.0 || seconds < 1.0 || seconds > 60.0)
+    {
+        std::printf("sampleRate >= 22050, seconds 1..60\n");
+        return 1;
+    }
+
+    if (!writeWav(fileFromArgument(argv[0]), makeSweep(sampleRate, seconds), sampleRate))
+    {
+        std::printf("cannot write %s\n", argv[0]);
+        return 1;
+    }
+
+    std::printf("%s: %.0f s sweep %.0f Hz -> %.0f Hz at %.0f Hz + %.0f s silence\n", argv[0], seconds,
+        sweepStartHz, std::min(sweepStopHz, 0.45 * sampleRate), sampleRate, tailSeconds);
+    std::printf("capture with: dkAmpTools ir-capture --seconds %g <recorded.wav> <IR folder>\n", seconds);
+    return 0;
+}
+
+int runIrCapture(int argc, char* argv[])
+{
+    double seconds = 10.0;
+    double lengthMs = 500.0;
+    std::vector<const char*> paths;
+
+    for (int i = 0; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--seconds") == 0 && i + 1 < argc)
+            seconds = std::atof(argv[++i]);
+        else if (std::strcmp(argv[i], "--length") == 0 && i + 1 < argc)
+            lengthMs = std::atof(argv[++i]);
+        else
+            paths.push_back(argv[i]);
+    }
+
+    if (paths.size() != 2u || seconds < 1.0 || seconds > 60.0 || lengthMs < 10.0)
+    {
+        std::printf("Use: dkAmpTools ir-capture [--seconds S=10] [--length ms=500] <recorded.wav> <IR folder | out.wav>\n");
+        return 1;
+    }
+
+    juce::File recordedFile = fileFromArgument(paths[0]);
+    juce::File out = fileFromArgument(paths[1]);
+
+    if (out.isDirectory())
+        out = out.getChildFile(recordedFile.getFileNameWithoutExtension() + " IR.wav");
+
+    std::vector<float> recording;
+    double sampleRate = 0.0;
+
+    if (!readWav(recordedFile, recording, sampleRate))
+    {
+        std::printf("cannot read %s\n", paths[0]);
+        return 1;
+    }
+
+    // the sweep is rebuilt at the recording's rate; a longer recording only adds lead-in and noise
+    std::vector<float> sweep = makeSweep(sampleRate, seconds);
+    recording.resize(std::min(recording.size(), sweep.size() + (size_t)(leadSeconds * sampleRate)));
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<float> h = deconvolve(recording, sweep, sampleRate);
+    auto end = std::chrono::steady_clock::now();
+
+    uint32_t peak = 0;
+    std::vector<float> ir = cutIR(h, sampleRate, (uint32_t)(lengthMs * 0.001 * sampleRate), peak);
+
+    if (!writeWav(out, ir, sampleRate))
+    {
+        std::printf("cannot write %s\n", out.getFullPathName().toRawUTF8());
+        return 1;
+    }
+
+    std::printf("%s: delay %.2f ms, IR %.1f ms at %.0f Hz, deconvolution (%u point real FFTs) %.3f s -> %s\n",
+        recordedFile.getFileName().toRawUTF8(), 1000.0 * peak / sampleRate, 1000.0 * ir.size() / sampleRate,
+        sampleRate, (uint32_t)h.size(), std::chrono::duration<double>(end - start).count(),
+        out.getFullPathName().toRawUTF8());
+    return 0;
+}
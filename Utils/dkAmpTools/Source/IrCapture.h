@@ -0,0 +1,26 @@
+/*
+  ==============================================================================
+
+    IrCapture.h
+    Created: 23 Oct 2026 5:02:38pm
+    Author:  dkuzn
+
+    Cab IR capture by exponential sine sweep (Farina). The recorded sweep is
+    deconvolved in the frequency domain (regularized division by the sweep
+    spectrum, one large real FFT each), the IR is cut from 1 ms before its
+    peak to where its decay falls below -60 dB, faded and saved as a 24 bit
+    WAV. Harmonic distortion of the chain lands before the peak and is cut
+    off with it. The recording may start anywhere in the first seconds, the
+    delay only moves the peak.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+
+// dkAmpTools gen-sweep <out.wav> [sampleRate] [seconds]
+int runGenSweep(int argc, char* argv[]);
+
+// dkAmpTools ir-capture [--seconds S] [--length ms] <recorded.wav> <IR folder | out.wav>
+int runIrCapture(int argc, char* argv[]);
@@ -0,0 +1,88 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 20 Oct 2026 10:14:03am
+    Author:  dkuzn
+
+    Command line tools built on the plugin DSP code.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include <cstdio>
+#include <cstring>
+#include "ResamplerBench.h"
+#include "ClipperBench.h"
+#include "FastMathCheck.h"
+#include "WdfCheck.h"
+#include "TriodeBench.h"
+#include "ProfileCapture.h"
+#include "IrCapture.h"
+#include "NeuralAmpBench.h"
+#include "EqBench.h"
+
+
+static void printUsage()
+{
+    std::printf("Use: dkAmpTools <command>\n\n");
+    std::printf("  bench-resampler    quality and speed of the IR resampler\n");
+    std::printf("  bench-clipper      alias suppression and cost of the diode clipper modes\n");
+    std::printf("  bench-triode       table accuracy and cost of the 12AX7 stage\n");
+    std::printf("  bench-eq           Biquad against SVF EQ backend, response and cost under automation\n");
+    std::printf("  bench-nam          accuracy and cost of the LSTM / GRU neural amp engine\n");
+    std::printf("  check-fastmath     accuracy and speed of FastMath.h against libm\n");
+    std::printf("  check-wdf          WDF.h diode pair and adaptors against DiodeClipper and analytic response\n");
+    std::printf("  gen-tones          write the amp profile capture stimulus (.wav)\n");
+    std::printf("  fit-profile        align recorded captures and write amp profiles (.dkap)\n");
+    std::printf("  gen-sweep          write the exponential sweep for cab IR capture (.wav)\n");
+    std::printf("  ir-capture         deconvolve a recorded sweep into a cab IR (.wav)\n");
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        printUsage();
+        return 1;
+    }
+
+    const char* command = argv[1];
+
+    if (std::strcmp(command, "bench-resampler") == 0)
+        return runResamplerBench();
+
+    if (std::strcmp(command, "bench-clipper") == 0)
+        return runClipperBench();
+
+    if (std::strcmp(command, "bench-triode") == 0)
+        return runTriodeBench();
+
+    if (std::strcmp(command, "bench-eq") == 0)
+        return runEqBench();
+
+    if (std::strcmp(command, "bench-nam") == 0)
+        return runNeuralAmpBench();
+
+    if (std::strcmp(command, "check-fastmath") == 0)
+        return runFastMathCheck();
+
+    if (std::strcmp(command, "check-wdf") == 0)
+        return runWdfCheck();
+
+    if (std::strcmp(command, "gen-tones") == 0)
+        return runGenTones(argc - 2, argv + 2);
+
+    if (std::strcmp(command, "fit-profile") == 0)
+        return runFitProfile(argc - 2, argv + 2);
+
+    if (std::strcmp(command, "gen-sweep") == 0)
+        return runGenSweep(argc - 2, argv + 2);
+
+    if (std::strcmp(command, "ir-capture") == 0)
+        return runIrCapture(argc - 2, argv + 2);
+
+    printUsage();
+    return 1;
+}
@@ -0,0 +1,191 @@
+/*
+  ==============================================================================
+
+    NeuralAmpBench.cpp
+    Created: 23 Oct 2026 7:48:20pm
+    Author:  dkuzn
+
+  ==============================================================================
+*/
+
+#include "NeuralAmpBench.h"
+#include "../../../Source/NeuralAmp.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#ifndef M_PI
+namespace
+{
+    const double M_PI = std::acos(-1.0);
+}
+#endif
+
+
+namespace
+{
+    const double sampleRate = 48000.0;
+    const double errorBound = 1e-4;
+
+    // PyTorch init: U(-1 / sqrt(hidden), 1 / sqrt(hidden))
+    NeuralAmp::Model randomModel(NeuralAmp::Cell cell, uint32_t hidden, uint32_t seed)
+    {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<float> u(-1.0f, 1.0f);
+        const float k = 1.0f / std::sqrt((float)hidden);
+
+        NeuralAmp::Model m;
+        m.cell = cell;
+        m.hidden = hidden;
+        m.skip = true;
+
+        const uint32_t rows = m.getRows();
+        auto fill = [&](std::vector<float>& v, size_t n, float scale)
+        {
+            v.resize(n);
+            for (auto& x : v)
+                x = scale * u(rng);
+        };
+
+        fill(m.weightIH, rows, 4.0f * k); // input gain of a trained model is larger
+        fill(m.weightHH, (size_t)rows * hidden, k);
+        fill(m.biasIH, rows, k);
+        fill(m.biasHH, rows, k);
+        fill(m.weightOut, hidden, k);
+        m.biasOut = 0.0f;
+        return m;
+    }
+
+    // straight from the PyTorch equations, double, libm
+    std::vector<float> reference(const NeuralAmp::Model& m, const std::vector<float>& input)
+    {
+        const uint32_t H = m.hidden;
+        const uint32_t rows = m.getRows();
+        std::vector<double> h(H, 0.0), c(H, 0.0), ax(rows), ah(rows);
+        std::vector<float> out(input.size());
+        auto sigmoid = [](double x) { return 1.0 / (1.0 + std::exp(-x)); };
+
+        for (size_t n = 0; n < input.size(); ++n)
+        {
+            for (uint32_t r = 0; r < rows; ++r)
+            {
+                ax[r] = m.weightIH[r] * (double)input[n] + m.biasIH[r];
+                ah[r] = m.biasHH[r];
+                for (uint32_t j = 0; j < H; ++j)
+                    ah[r] += m.weightHH[(size_t)r * H + j] * h[j];
+            }
+
+            for (uint32_t j = 0; j < H; ++j)
+            {
+                if (m.cell == NeuralAmp::Cell::LSTM)
+                {
+                    double i = sigmoid(ax[j] + ah[j]);
+                    double f = sigmoid(ax[H + j] + ah[H + j]);
+                    double g = std::tanh(ax[2 * H + j] + ah[2 * H + j]);
+                    double o = sigmoid(ax[3 * H + j] + ah[3 * H + j]);
+                    c[j] = f * c[j] + i * g;
+                    h[j] = o * std::tanh(c[j]);
+                }
+                else
+                {
+                    double r = sigmoid(ax[j] + ah[j]);
+                    double z = sigmoid(ax[H + j] + ah[H + j]);
+                    double g = std::tanh(ax[2 * H + j] + r * ah[2 * H + j]);
+                    h[j] = (1.0 - z) * g + z * h[j];
+                }
+            }
+
+            double y = m.biasOut;
+            for (uint32_t j = 0; j < H; ++j)
+                y += m.weightOut[j] * h[j];
+
+            out[n] = (float)(m.skip ? y + input[n] : y);
+        }
+        return out;
+    }
+
+    // decaying plucks of a low E string and its harmonics
+    std::vector<float> guitar(uint32_t length)
+    {
+        std::vector<float> x(length);
+        for (uint32_t i = 0; i < length; ++i)
+        {
+            double t = (i % 24000u) / sampleRate;
+            double env = 0.8 * std::exp(-4.0 * t);
+            x[i] = (float)(env * (std::sin(2.0 * M_PI * 82.4 * t) + 0.5 * std::sin(2.0 * M_PI * 164.8 * t) + 0.25 * std::sin(2.0 * M_PI * 247.2 * t)) / 1.75);
+        }
+        return x;
+    }
+}
+
+
+int runNeuralAmpBench()
+{
+    struct Case
+    {
+        const char* name;
+        NeuralAmp::Cell cell;
+        uint32_t hidden;
+    };
+
+    const Case cases[] = {
+        { "LSTM", NeuralAmp::Cell::LSTM, 8u },
+        { "LSTM", NeuralAmp::Cell::LSTM, 10u }, // padded gates
+        { "LSTM", NeuralAmp::Cell::LSTM, 12u },
+        { "LSTM", NeuralAmp::Cell::LSTM, 16u },
+        { "LSTM", NeuralAmp::Cell::LSTM, 20u },
+        { "LSTM", NeuralAmp::Cell::LSTM, 32u },
+        { "LSTM", NeuralAmp::Cell::LSTM, 40u },
+        { "GRU",  NeuralAmp::Cell::GRU,  10u },
+        { "GRU",  NeuralAmp::Cell::GRU,  16u },
+        { "GRU",  NeuralAmp::Cell::GRU,  32u },
+    };
+
+    const uint32_t checkLength = 48000u;
+    const uint32_t timeLength = 1u << 18;
+    const int blockSize = 256;
+    int failures = 0;
+
+    std::vector<float> checkInput = guitar(checkLength);
+    std::vector<float> timeInput = guitar(timeLength);
+
+    std::printf("%-6s %6s %12s %12s %10s %16s  %s\n", "cell", "hidden", "max error", "bound", "ns/sample", "instances/core", "result");
+
+    for (const Case& c : cases)
+    {
+        NeuralAmp::Model model = randomModel(c.cell, c.hidden, 1234u + c.hidden);
+        NeuralAmp amp;
+        amp.setModel(model);
+
+        std::vector<float> ref = reference(model, checkInput);
+        std::vector<float> out = checkInput;
+        for (uint32_t i = 0; i < checkLength; i += (uint32_t)blockSize)
+            amp.processBlock(out.data() + i, std::min(blockSize, (int)(checkLength - i)));
+
+        double maxError = 0.0;
+        for (uint32_t i = 0; i < checkLength; ++i)
+            maxError = std::max(maxError, (double)std::fabs(out[i] - ref[i]));
+
+        amp.reset();
+        std::vector<float> x = timeInput;
+        auto start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < timeLength; i += (uint32_t)blockSize)
+            amp.processBlock(x.data() + i, blockSize);
+        auto end = std::chrono::steady_clock::now();
+
+        if (x[timeLength / 2u] == 12345.0f)
+            std::printf(" ");
+
+        double ns = std::chrono::duration<double, std::nano>(end - start).count() / timeLength;
+        bool pass = maxError <= errorBound;
+        failures += pass ? 0 : 1;
+
+        std::printf("%-6s %6u %12.3g %12.3g %10.1f %16.0f  %s\n", c.name, c.hidden, maxError, errorBound, ns,
+            1.0e9 / (ns * sampleRate), pass ? "ok" : "FAIL");
+    }
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,18 @@
+/*
+  ==============================================================================
+
+    NeuralAmpBench.h
+    Created: 23 Oct 2026 7:48:20pm
+    Author:  dkuzn
+
+  ==============================================================================
+*/
+
+#pragma once
+
+
+// NeuralAmp with random LSTM / GRU weights of typical sizes: error of the
+// packed fast-math engine against a plain PyTorch layout reference (libm),
+// ns per sample and real-time instances per core at 48 kHz.
+// Returns 1 if the error exceeds its bound.
+int runNeuralAmpBench();
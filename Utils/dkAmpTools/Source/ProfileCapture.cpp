@@ -0,0 +1,372 @@
+/*
+  ==============================================================================
+
+    ProfileCapture.cpp
+    Created: 23 Oct 2026 2:41:52pm
+    Author:  dkuzn
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "ProfileCapture.h"
+#include "AudioFile.h"
+#include "../../../Source/AmpProfile.h"
+#include "../../../Source/FFT.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef M_PI
+namespace
+{
+    const double M_PI = std::acos(-1.0);
+}
+#endif
+
+
+namespace
+{
+    const float bandHz[AmpProfile::numBands] = { 200.0f, 1000.0f, 8000.0f };
+    const float crossoverHz[AmpProfile::numBands - 1u] = { 447.0f, 2828.0f };
+
+    const double chirpSeconds = 0.5;
+    const double gapSeconds = 0.5;
+    const double chirpLevel = 0.25; // -12 dBFS, well below clipping of most amps
+    const double searchSeconds = 5.0; // max. offset of the chirp in the recording
+    const double settleFraction = 0.25; // start of every step skipped by the fit
+
+    struct Layout
+    {
+        Layout(double fs, uint32_t numSteps, double stepMs)
+            : sampleRate(fs),
+              steps(numSteps),
+              chirpLength((uint32_t)(chirpSeconds * fs)),
+              gapLength((uint32_t)(gapSeconds * fs)),
+              stepLength((uint32_t)(stepMs * 0.001 * fs))
+        {
+        }
+
+        uint32_t toneStart(uint32_t band) const { return chirpLength + gapLength + band * steps * stepLength; }
+        uint32_t totalLength() const { return toneStart(AmpProfile::numBands); }
+        float amplitude(uint32_t step) const { return (float)(step + 1u) / (float)steps; }
+
+        double sampleRate;
+        uint32_t steps;
+        uint32_t chirpLength;
+        uint32_t gapLength;
+        uint32_t stepLength;
+    };
+
+    std::vector<float> makeChirp(const Layout& layout)
+    {
+        // exponential sweep, phase 2pi * f0 * T / ln(f1 / f0) * (e^(t / T * ln(f1 / f0)) - 1)
+        const double f0 = 50.0;
+        const double f1 = std::min(10000.0, 0.45 * layout.sampleRate);
+        const double T = chirpSeconds;
+        const double k = std::log(f1 / f0);
+
+        std::vector<float> x(layout.chirpLength);
+        for (uint32_t i = 0; i < layout.chirpLength; ++i)
+        {
+            double t = i / layout.sampleRate;
+            double fade = std::min(1.0, std::min(t, T - t) / 0.01); // 10 ms fades
+            x[i] = (float)(chirpLevel * fade * std::sin(2.0 * M_PI * f0 * T / k * (std::exp(t / T * k) - 1.0)));
+        }
+        return x;
+    }
+
+    std::vector<float> makeStimulus(const Layout& layout)
+    {
+        std::vector<float> x(layout.totalLength(), 0.0f);
+        std::vector<float> chirp = makeChirp(layout);
+        std::copy(chirp.begin(), chirp.end(), x.begin());
+
+        for (uint32_t band = 0; band < AmpProfile::numBands; ++band)
+        {
+            // continuous phase, the amplitude changes from step to step
+            const double w = 2.0 * M_PI * bandHz[band] / layout.sampleRate;
+            uint32_t n = layout.toneStart(band);
+
+            for (uint32_t step = 0; step < layout.steps; ++step)
+            {
+                for (uint32_t i = 0; i < layout.stepLength; ++i, ++n)
+                    x[n] = layout.amplitude(step) * (float)std::sin(w * (n - layout.toneStart(band)));
+            }
+        }
+        return x;
+    }
+
+    // offset of the chirp in the recording (-1 if not found), normalized correlation in quality
+    int64_t findChirp(const std::vector<float>& recording, const std::vector<float>& chirp, double sampleRate, double& quality)
+    {
+        FFT fft;
+        const uint32_t search = (uint32_t)std::min<size_t>((size_t)(searchSeconds * sampleRate), recording.size());
+        const uint32_t size = fft.calculateFFTWindow(search + (uint32_t)chirp.size());
+
+        std::vector<float> xRe(size, 0.0f), xIm(size, 0.0f);
+        std::vector<float> cRe(size, 0.0f), cIm(size, 0.0f);
+        std::copy(recording.begin(), recording.begin() + search, xRe.begin());
+        std::copy(chirp.begin(), chirp.end(), cRe.begin());
+
+        fft.FFT_process(xRe.data(), xIm.data(), size);
+        fft.FFT_process(cRe.data(), cIm.data(), size);
+
+        // X * conj(C) -> cross-correlation, lag >= 0 at the front
+        for (uint32_t i = 0; i < size; ++i)
+        {
+            float re = xRe[i] * cRe[i] + xIm[i] * cIm[i];
+            float im = xIm[i] * cRe[i] - xRe[i] * cIm[i];
+            xRe[i] = re;
+            xIm[i] = im;
+        }
+
+        fft.IFFT_process(xRe.data(), xIm.data(), size);
+
+        uint32_t lag = 0;
+        for (uint32_t i = 1; i < search; ++i)
+        {
+            if (std::fabs(xRe[i]) > std::fabs(xRe[lag]))
+                lag = i;
+        }
+
+        if ((size_t)lag + chirp.size() > recording.size())
+            return -1;
+
+        double xc = 0.0, xx = 0.0, cc = 0.0;
+        for (size_t i = 0; i < chirp.size(); ++i)
+        {
+            xc += (double)recording[lag + i] * chirp[i];
+            xx += (double)recording[lag + i] * recording[lag + i];
+            cc += (double)chirp[i] * chirp[i];
+        }
+
+        quality = (xx > 0.0) ? std::fabs(xc) / std::sqrt(xx * cc) : 0.0;
+        return (int64_t)lag;
+    }
+
+    // |out| / |in| per step, on whole tone periods after the settling part
+    void fitBand(const std::vector<float>& recording, const std::vector<float>& stimulus, const Layout& layout,
+        uint32_t band, size_t offset, float* gain)
+    {
+        const double period = layout.sampleRate / bandHz[band];
+        const uint32_t skip = (uint32_t)(settleFraction * layout.stepLength);
+        const uint32_t periods = (uint32_t)((layout.stepLength - skip) / period);
+        const uint32_t length = std::max(1u, (uint32_t)(periods * period));
+
+        for (uint32_t step = 0; step < layout.steps; ++step)
+        {
+            size_t start = layout.toneStart(band) + (size_t)step * layout.stepLength + skip;
+            const float* x = &stimulus[start];
+            const float* y = &recording[offset + start];
+
+            double mean = 0.0;
+            for (uint32_t i = 0; i < length; ++i)
+                mean += y[i];
+            mean /= length;
+
+            double sumIn = 0.0, sumOut = 0.0;
+            for (uint32_t i = 0; i < length; ++i)
+            {
+                sumIn += std::fabs(x[i]);
+                sumOut += std::fabs(y[i] - mean);
+            }
+
+            gain[step] = (sumIn > 0.0) ? (float)(sumOut / sumIn) : 0.0f;
+        }
+    }
+
+    // runs job(0 .. count - 1) on up to numThreads threads
+    template <typename F>
+    void parallelFor(uint32_t count, uint32_t numThreads, F job)
+    {
+        std::atomic<uint32_t> next{ 0 };
+        auto worker = [&]()
+        {
+            for (uint32_t i = next++; i < count; i = next++)
+                job(i);
+        };
+
+        std::vector<std::thread> threads;
+        for (uint32_t t = 1; t < std::min(numThreads, count); ++t)
+            threads.emplace_back(worker);
+
+        worker();
+
+        for (auto& t : threads)
+            t.join();
+    }
+
+    struct Capture
+    {
+        juce::File file;
+        std::vector<float> recording;
+        double sampleRate = 0.0;
+        int64_t offset = -1;
+        double quality = 0.0;
+        AmpProfile profile;
+        const char* error = nullptr;
+    };
+}
+
+
+int runGenTones(int argc, char* argv[])
+{
+    if (argc < 1)
+    {
+        std::printf("Use: dkAmpTools gen-tones <out.wav> [sampleRate=48000] [steps=100] [stepMs=50]\n");
+        return 1;
+    }
+
+    const double sampleRate = (argc > 1) ? std::atof(argv[1]) : 48000.0;
+    const uint32_t steps = (argc > 2) ? (uint32_t)std::atoi(argv[2]) : 100u;
+    const double stepMs = (argc > 3) ? std::atof(argv[3]) : 50.0;
+
+    if (sampleRate < 22050.0 || steps < 2u || stepMs < 10.0)
+    {
+        std::printf("sampleRate >= 22050, steps >= 2, stepMs >= 10\n");
+        return 1;
+    }
+
+    Layout layout(sampleRate, steps, stepMs);
+    juce::File file = fileFromArgument(argv[0]);
+
+    if (!writeWav(file, makeStimulus(layout), sampleRate))
+    {
+        std::printf("cannot write %s\n", argv[0]);
+        return 1;
+    }
+
+    std::printf("%s: %.1f s at %.0f Hz, %u steps of %.0f ms per band\n",
+        argv[0], layout.totalLength() / sampleRate, sampleRate, steps, stepMs);
+    std::printf("fit with: dkAmpTools fit-profile --steps %u --step-ms %g <recorded.wav>\n", steps, stepMs);
+    return 0;
+}
+
+int runFitProfile(int argc, char* argv[])
+{
+    uint32_t steps = 100u;
+    double stepMs = 50.0;
+    uint32_t numThreads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<Capture> captures;
+
+    for (int i = 0; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--steps") == 0 && i + 1 < argc)
+            steps = (uint32_t)std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--step-ms") == 0 && i + 1 < argc)
+            stepMs = std::atof(argv[++i]);
+        else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            numThreads = std::max(1, std::atoi(argv[++i]));
+        else
+        {
+            captures.emplace_back();
+            captures.back().file = fileFromArgument(argv[i]);
+        }
+    }
+
+    if (captures.empty() || steps < 2u || stepMs < 10.0)
+    {
+        std::printf("Use: dkAmpTools fit-profile [--steps N] [--step-ms M] [--threads T] <recorded.wav>...\n");
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    const uint32_t numCaptures = (uint32_t)captures.size();
+
+    // read and align every recording
+    parallelFor(numCaptures, numThreads, [&](uint32_t i)
+    {
+        Capture& c = captures[i];
+
+        if (!readWav(c.file, c.recording, c.sampleRate))
+        {
+            c.error = "cannot read";
+            return;
+        }
+
+        Layout layout(c.sampleRate, steps, stepMs);
+        c.offset = findChirp(c.recording, makeChirp(layout), c.sampleRate, c.quality);
+
+        if (c.offset < 0 || c.quality < 0.1)
+            c.error = "sync chirp not found";
+        else if ((size_t)c.offset + layout.totalLength() > c.recording.size())
+            c.error = "recording shorter than the stimulus";
+    });
+
+    // one job per recording and band
+    std::vector<std::vector<float>> stimuli(numCaptures);
+
+    for (uint32_t i = 0; i < numCaptures; ++i)
+    {
+        Capture& c = captures[i];
+        if (c.error != nullptr)
+            continue;
+
+        c.profile.numSteps = steps;
+        c.profile.ampMin = Layout(c.sampleRate, steps, stepMs).amplitude(0);
+        c.profile.ampMax = 1.0f;
+        std::copy(std::begin(bandHz), std::end(bandHz), c.profile.bandHz);
+        std::copy(std::begin(crossoverHz), std::end(crossoverHz), c.profile.crossoverHz);
+        c.profile.gain.assign((size_t)AmpProfile::numBands * steps, 0.0f);
+
+        // recordings at the same rate share the stimulus
+        for (uint32_t j = 0; j < i && stimuli[i].empty(); ++j)
+        {
+            if (!stimuli[j].empty() && captures[j].sampleRate == c.sampleRate)
+                stimuli[i] = stimuli[j];
+        }
+
+        if (stimuli[i].empty())
+            stimuli[i] = makeStimulus(Layout(c.sampleRate, steps, stepMs));
+    }
+
+    parallelFor(numCaptures * AmpProfile::numBands, numThreads, [&](uint32_t job)
+    {
+        Capture& c = captures[job / AmpProfile::numBands];
+        uint32_t band = job % AmpProfile::numBands;
+
+        if (c.error == nullptr)
+            fitBand(c.recording, stimuli[job / AmpProfile::numBands], Layout(c.sampleRate, steps, stepMs),
+                band, (size_t)c.offset, &c.profile.gain[(size_t)band * steps]);
+    });
+
+    int result = 0;
+
+    for (Capture& c : captures)
+    {
+        juce::String name = c.file.getFileName();
+
+        if (c.error == nullptr)
+        {
+            std::vector<uint8_t> data = c.profile.serialize();
+            juce::File out = c.file.withFileExtension(".dkap");
+
+            if (!out.replaceWithData(data.data(), data.size()))
+                c.error = "cannot write .dkap";
+            else
+                std::printf("%s: offset %.2f ms, sync %.3f, gain 200 Hz %.2f..%.2f -> %s\n",
+                    name.toRawUTF8(), 1000.0 * c.offset / c.sampleRate, c.quality,
+                    c.profile.gain[0], c.profile.gain[steps - 1u], out.getFileName().toRawUTF8());
+        }
+
+        if (c.error != nullptr)
+        {
+            std::printf("%s: %s\n", name.toRawUTF8(), c.error);
+            result = 1;
+        }
+    }
+
+    auto end = std::chrono::steady_clock::now();
+    std::printf("%u recording(s) in %.2f s on %u thread(s)\n", numCaptures,
+        std::chrono::duration<double>(end - start).count(), std::min(numThreads, numCaptures * AmpProfile::numBands));
+
+    return result;
+}
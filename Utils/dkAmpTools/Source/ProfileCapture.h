@@ -0,0 +1,28 @@
+/*
+  ==============================================================================
+
+    ProfileCapture.h
+    Created: 23 Oct 2026 2:41:52pm
+    Author:  dkuzn
+
+    Native replacement of testToneGen.py / transitionGen.py.
+
+    Stimulus (mono, 24 bit): a sync chirp 50 Hz -> 10 kHz at -12 dBFS,
+    silence, then for each band tone (200 Hz, 1 kHz, 8 kHz) numSteps
+    constant amplitude steps from 1 / numSteps to full scale. The fit finds
+    the chirp in the recording by cross-correlation, so the recording may
+    start anywhere within the first 5 s and may have any latency; the
+    stimulus is rebuilt at the recording's sample rate.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+
+// dkAmpTools gen-tones <out.wav> [sampleRate] [steps] [stepMs]
+int runGenTones(int argc, char* argv[]);
+
+// dkAmpTools fit-profile [--steps N] [--step-ms M] [--threads T] <recorded.wav>...
+// writes <recorded>.dkap next to every recording
+int runFitProfile(int argc, char* argv[]);
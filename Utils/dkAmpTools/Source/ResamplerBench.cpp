@@ -0,0 +1,212 @@
+/*
+  ==============================================================================
+
+    ResamplerBench.cpp
+    Created: 20 Oct 2026 10:14:03am
+    Author:  dkuzn
+
+  ==============================================================================
+*/
+
+#include "ResamplerBench.h"
+#include "../../../Source/Resampler.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#ifndef M_PI
+namespace
+{
+    const double M_PI = std::acos(-1.0);
+}
+#endif
+
+
+namespace
+{
+    const double toneAmplitude = 0.5;
+
+    std::vector<float> makeTone(double freq, uint32_t sampleRate, uint32_t length)
+    {
+        std::vector<float> tone(length);
+        for (uint32_t n = 0; n < length; ++n)
+            tone[n] = (float)(toneAmplitude * std::sin(2.0 * M_PI * freq * n / sampleRate));
+        return tone;
+    }
+
+    // Least squares fit of a tone at freq over the middle 80% of the signal (edges hold
+    // the filter transients). Returns the fitted amplitude and residual power.
+    void fitTone(const float* y, uint32_t length, double freq, uint32_t sampleRate,
+        double& amplitude, double& residualPower)
+    {
+        uint32_t start = length / 10u;
+        uint32_t end = length - length / 10u;
+
+        double ss = 0.0, cc = 0.0, sc = 0.0, ys = 0.0, yc = 0.0;
+        for (uint32_t n = start; n < end; ++n)
+        {
+            double w = 2.0 * M_PI * freq * n / sampleRate;
+            double s = std::sin(w), c = std::cos(w);
+            ss += s * s; cc += c * c; sc += s * c;
+            ys += y[n] * s; yc += y[n] * c;
+        }
+
+        double det = ss * cc - sc * sc;
+        double a = (det != 0.0) ? (ys * cc - yc * sc) / det : 0.0;
+        double b = (det != 0.0) ? (yc * ss - ys * sc) / det : 0.0;
+
+        amplitude = std::sqrt(a * a + b * b);
+
+        double err = 0.0;
+        for (uint32_t n = start; n < end; ++n)
+        {
+            double w = 2.0 * M_PI * freq * n / sampleRate;
+            double e = y[n] - (a * std::sin(w) + b * std::cos(w));
+            err += e * e;
+        }
+        residualPower = err / (end - start);
+    }
+
+    double toDB(double powerRatio)
+    {
+        return 10.0 * std::log10(std::max(powerRatio, 1e-30));
+    }
+
+    std::vector<float> resampleTone(double freq, uint32_t srcSampleRate, uint32_t dstSampleRate)
+    {
+        auto tone = makeTone(freq, srcSampleRate, srcSampleRate / 4u);
+
+        float* dst = nullptr;
+        uint32_t dstLength = 0;
+        Resampler::resample(srcSampleRate, dstSampleRate, tone.data(), (uint32_t)tone.size(), dst, dstLength);
+
+        std::vector<float> out(dst, dst + dstLength);
+        delete[] dst;
+        return out;
+    }
+}
+
+ResamplerReport measureResampler(uint32_t srcSampleRate, uint32_t dstSampleRate)
+{
+    ResamplerReport report;
+    report.srcSampleRate = srcSampleRate;
+    report.dstSampleRate = dstSampleRate;
+
+    const double inputPower = 0.5 * toneAmplitude * toneAmplitude;
+    const uint32_t lowRate = std::min(srcSampleRate, dstSampleRate);
+    const double passbandEdge = std::min(20000.0, 0.45 * lowRate);
+
+    // passband ripple and images: tones up to the passband edge
+    double minGain = 1e9, maxGain = 0.0, worstLeak = 0.0;
+    for (double freq = 50.0; freq <= passbandEdge; freq *= 1.25)
+    {
+        auto out = resampleTone(freq, srcSampleRate, dstSampleRate);
+
+        double amplitude, residual;
+        fitTone(out.data(), (uint32_t)out.size(), freq, dstSampleRate, amplitude, residual);
+
+        minGain = std::min(minGain, amplitude / toneAmplitude);
+        maxGain = std::max(maxGain, amplitude / toneAmplitude);
+        worstLeak = std::max(worstLeak, residual / inputPower);
+    }
+    report.passbandRippleDB = 20.0 * std::log10(maxGain / minGain);
+
+    // downsampling: tones above the output Nyquist have to be removed
+    if (dstSampleRate < srcSampleRate)
+    {
+        for (double freq = 0.55 * dstSampleRate; freq < 0.5 * srcSampleRate; freq += 0.05 * dstSampleRate)
+        {
+            auto out = resampleTone(freq, srcSampleRate, dstSampleRate);
+
+            uint32_t start = (uint32_t)out.size() / 10u;
+            uint32_t end = (uint32_t)out.size() - start;
+            double power = 0.0;
+            for (uint32_t n = start; n < end; ++n)
+                power += (double)out[n] * out[n];
+
+            worstLeak = std::max(worstLeak, power / (end - start) / inputPower);
+        }
+    }
+    report.aliasRejectionDB = -toDB(worstLeak);
+
+    // SNR against the ideal 1 kHz tone
+    {
+        auto out = resampleTone(1000.0, srcSampleRate, dstSampleRate);
+        auto ideal = makeTone(1000.0, dstSampleRate, (uint32_t)out.size());
+
+        uint32_t start = (uint32_t)out.size() / 10u;
+        uint32_t end = (uint32_t)out.size() - start;
+        double signal = 0.0, noise = 0.0;
+        for (uint32_t n = start; n < end; ++n)
+        {
+            double e = out[n] - ideal[n];
+            signal += (double)ideal[n] * ideal[n];
+            noise += e * e;
+        }
+        report.snrDB = toDB(signal / std::max(noise, 1e-30));
+    }
+
+    // throughput: 1 second of signal, best of 5 runs
+    {
+        auto tone = makeTone(1000.0, srcSampleRate, srcSampleRate);
+        double best = 1e9;
+        uint32_t dstLength = 0;
+
+        for (int run = 0; run < 5; ++run)
+        {
+            float* dst = nullptr;
+            auto start = std::chrono::steady_clock::now();
+            Resampler::resample(srcSampleRate, dstSampleRate, tone.data(), (uint32_t)tone.size(), dst, dstLength);
+            best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+            delete[] dst;
+        }
+        report.samplesPerSecond = dstLength / best;
+
+        StreamingResampler streaming;
+        streaming.prepare(srcSampleRate, dstSampleRate);
+        const uint32_t blockSize = 256u;
+        std::vector<float> out(streaming.getMaxOutput(blockSize));
+
+        best = 1e9;
+        uint32_t produced = 0;
+        for (int run = 0; run < 5; ++run)
+        {
+            streaming.reset();
+            produced = 0;
+            auto start = std::chrono::steady_clock::now();
+            for (uint32_t pos = 0; pos + blockSize <= tone.size(); pos += blockSize)
+                produced += streaming.process(&tone[pos], blockSize, out.data());
+            best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        }
+        report.streamingSamplesPerSecond = produced / best;
+    }
+
+    return report;
+}
+
+int runResamplerBench()
+{
+    const uint32_t rates[] = { 44100u, 48000u, 88200u, 96000u, 192000u };
+
+    std::printf("%8s %8s %12s %14s %9s %14s %14s\n",
+        "src", "dst", "ripple [dB]", "alias rej [dB]", "SNR [dB]", "offline [MS/s]", "stream [MS/s]");
+
+    for (uint32_t src : rates)
+    {
+        for (uint32_t dst : rates)
+        {
+            if (src == dst)
+                continue;
+
+            ResamplerReport r = measureResampler(src, dst);
+
+            std::printf("%8u %8u %12.4f %14.1f %9.1f %14.2f %14.2f\n",
+                r.srcSampleRate, r.dstSampleRate, r.passbandRippleDB, r.aliasRejectionDB,
+                r.snrDB, r.samplesPerSecond * 1e-6, r.streamingSamplesPerSecond * 1e-6);
+        }
+    }
+
+    return 0;
+}
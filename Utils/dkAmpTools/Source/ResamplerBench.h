@@ -0,0 +1,31 @@
+/*
+  ==============================================================================
+
+    ResamplerBench.h
+    Created: 20 Oct 2026 10:14:03am
+    Author:  dkuzn
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <cstdint>
+
+
+struct ResamplerReport
+{
+    uint32_t srcSampleRate = 0;
+    uint32_t dstSampleRate = 0;
+    double passbandRippleDB = 0.0; // max - min gain of test tones up to 20 kHz (or 0.45 * lower rate)
+    double aliasRejectionDB = 0.0; // worst leak of stopband tones / images, relative to input
+    double snrDB = 0.0; // 1 kHz tone against the ideal resampled tone
+    double samplesPerSecond = 0.0; // offline Resampler::resample output rate
+    double streamingSamplesPerSecond = 0.0; // StreamingResampler output rate
+};
+
+// Measures quality and speed of Resampler for one rate pair
+ResamplerReport measureResampler(uint32_t srcSampleRate, uint32_t dstSampleRate);
+
+// Sweeps all pairs of 44.1, 48, 88.2, 96 and 192 kHz and prints a table
+int runResamplerBench();
@@ -0,0 +1,111 @@
+/*
+  ==============================================================================
+
+    TriodeBench.cpp
+    Created: 22 Oct 2026 4:51:09pm
+    Author:  dkuzn
+
+  ==============================================================================
+*/
+
+#include "TriodeBench.h"
+#include "../../../Source/Preamp.h"
+#include "../../../Source/ParamEq.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#ifndef M_PI
+namespace
+{
+    const double M_PI = std::acos(-1.0);
+}
+#endif
+
+
+namespace
+{
+    // the stage runs at the oversampled rate in the plugin
+    const double sampleRate = 96000.0;
+    const double toneHz = 1000.0;
+    const float driveLevels[] = { 0.1f, 1.0f, 4.0f, 10.0f }; // peak grid voltage [V]
+    const uint32_t length = 96000u;
+
+    std::vector<float> tone(float drive, uint32_t n)
+    {
+        std::vector<float> x(n);
+        for (uint32_t i = 0; i < n; ++i)
+            x[i] = drive * (float)std::sin(2.0 * M_PI * toneHz * i / sampleRate);
+        return x;
+    }
+
+    template <typename F>
+    double nsPerSample(F process, uint32_t n)
+    {
+        std::vector<float> x = tone(4.0f, n);
+
+        auto start = std::chrono::steady_clock::now();
+        process(x.data(), n);
+        auto end = std::chrono::steady_clock::now();
+
+        if (x[n / 2u] == 12345.0f)
+            std::printf(" ");
+
+        return std::chrono::duration<double, std::nano>(end - start).count() / n;
+    }
+}
+
+
+int runTriodeBench()
+{
+    TriodeStage table;
+    TriodeStage exact;
+    table.prepare(sampleRate);
+    exact.prepare(sampleRate);
+    exact.setMode(TriodeStage::Mode::Exact);
+
+    std::printf("12AX7, B+ 250 V, Rp 100k, Rk 1.5k || 22 uF at %.0f Hz, small-signal gain %.1f\n\n",
+        sampleRate, table.getSmallSignalGain());
+    std::printf("%-10s %14s %14s %14s\n", "drive [V]", "out min", "out max", "table err");
+
+    for (float drive : driveLevels)
+    {
+        table.reset();
+        exact.reset();
+
+        std::vector<float> a = tone(drive, length);
+        std::vector<float> b = a;
+        table.processBlock(a.data(), (int)length);
+        exact.processBlock(b.data(), (int)length);
+
+        // second half: coupling cap settled
+        double maxError = 0.0;
+        float lo = 0.0f;
+        float hi = 0.0f;
+
+        for (uint32_t i = length / 2u; i < length; ++i)
+        {
+            maxError = std::max(maxError, (double)std::fabs(a[i] - b[i]));
+            lo = std::min(lo, b[i]);
+            hi = std::max(hi, b[i]);
+        }
+
+        std::printf("%-10g %14.4f %14.4f %14.3g\n", drive, lo, hi, maxError);
+    }
+
+    Biquad biquad;
+    biquad.setParams(Biquad::Peak, sampleRate, 800.0, 0.7, 6.0f);
+
+    std::printf("\n%-10s %10s\n", "", "ns/sample");
+    std::printf("%-10s %10.1f\n", "table", nsPerSample([&](float* x, uint32_t n) { table.processBlock(x, (int)n); }, 1u << 20));
+    std::printf("%-10s %10.1f\n", "exact", nsPerSample([&](float* x, uint32_t n) { exact.processBlock(x, (int)n); }, 1u << 14));
+    std::printf("%-10s %10.1f\n", "Biquad", nsPerSample([&](float* x, uint32_t n)
+    {
+        for (uint32_t i = 0; i < n; ++i)
+            x[i] = biquad.processSample(x[i]);
+    }, 1u << 20));
+
+    return 0;
+}
@@ -0,0 +1,16 @@
+/*
+  ==============================================================================
+
+    TriodeBench.h
+    Created: 22 Oct 2026 4:51:09pm
+    Author:  dkuzn
+
+  ==============================================================================
+*/
+
+#pragma once
+
+
+// TriodeStage: operating point, table against exact solve per drive level,
+// cost per sample of both modes next to a Biquad
+int runTriodeBench();
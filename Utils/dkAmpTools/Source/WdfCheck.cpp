@@ -0,0 +1,179 @@
+/*
+  ==============================================================================
+
+    WdfCheck.cpp
+    Created: 22 Oct 2026 2:18:44pm
+    Author:  dkuzn
+
+  ==============================================================================
+*/
+
+#include "WdfCheck.h"
+#include "../../../Source/WDF.h"
+#include "../../../Source/DiodeClipper.h"
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <vector>
+
+#ifndef M_PI
+namespace
+{
+    const double M_PI = std::acos(-1.0);
+}
+#endif
+
+
+namespace
+{
+    // same settings as the plugin clipper
+    const float seriesR = 100000.0f;
+    const float Is = 1.0e-9f;
+    const float nVt = 25.85e-3f;
+
+    const float sampleRate = 48000.0f;
+    const float couplingC = 100e-9f;
+    const float toneC = 100e-12f;
+
+    const double curveBound = 1e-6; // [V], default refineSteps
+    const double responseBound = 1e-4; // relative
+
+    template <typename F>
+    double nsPerSample(F process)
+    {
+        const uint32_t length = 1u << 20;
+        float sink = 0.0f;
+
+        auto start = std::chrono::steady_clock::now();
+        for (uint32_t n = 0; n < length; ++n)
+            sink += process(20.0f * (float)std::sin(2.0 * M_PI * 997.0 * n / sampleRate));
+        auto end = std::chrono::steady_clock::now();
+
+        if (sink == 12345.0f)
+            std::printf(" ");
+
+        return std::chrono::duration<double, std::nano>(end - start).count() / length;
+    }
+
+    // ResistiveVoltageSource -> DiodePair on a +-32 V ramp, max |WDF - DiodeClipper|
+    double curveError(int refineSteps)
+    {
+        const uint32_t length = 65536u;
+
+        std::vector<float> reference(length);
+        for (uint32_t n = 0; n < length; ++n)
+            reference[n] = -32.0f + 64.0f * (float)n / (float)(length - 1u);
+
+        std::vector<float> input = reference;
+
+        DiodeClipper clipper(seriesR, Is, nVt);
+        clipper.processBlock(reference.data(), (int)length);
+
+        wdf::ResistiveVoltageSource vs { seriesR };
+        wdf::DiodePair dp { vs, Is, nVt, refineSteps };
+
+        double maxError = 0.0;
+
+        for (uint32_t n = 0; n < length; ++n)
+        {
+            vs.setVoltage(input[n]);
+            dp.process();
+            maxError = std::max(maxError, std::fabs((double)dp.voltage() - reference[n]));
+        }
+
+        return maxError;
+    }
+
+    // Vs -> R + Cc -> (Ct || diodes), 1 mV tone: diodes act as conductance 2*Is/nVt.
+    // Compared with the analog transfer function at the bilinear-warped frequency.
+    double responseError(double frequency)
+    {
+        wdf::ResistiveVoltageSource vs { seriesR };
+        wdf::Capacitor cc { couplingC, sampleRate };
+        wdf::Series s { vs, cc };
+        wdf::PolarityInverter inv { s };
+        wdf::Capacitor ct { toneC, sampleRate };
+        wdf::Parallel p { inv, ct };
+        wdf::DiodePair dp { p, Is, nVt };
+
+        const uint32_t settle = 19200u; // 20 time constants of R * Cc
+        const uint32_t length = 4800u; // integer number of periods for 100 Hz multiples
+        const double w = 2.0 * M_PI * frequency / sampleRate;
+
+        std::complex<double> X = 0.0;
+        std::complex<double> Y = 0.0;
+
+        for (uint32_t n = 0; n < settle + length; ++n)
+        {
+            float x = 1e-3f * (float)std::sin(w * n);
+            vs.setVoltage(x);
+            dp.process();
+
+            if (n >= settle)
+            {
+                std::complex<double> e = std::polar(1.0, -w * n);
+                X += (double)x * e;
+                Y += (double)ct.voltage() * e;
+            }
+        }
+
+        const double omega = 2.0 * sampleRate * std::tan(0.5 * w);
+        const std::complex<double> jw(0.0, omega);
+        const std::complex<double> Zt = 1.0 / (jw * (double)toneC + 2.0 * Is / nVt);
+        const std::complex<double> H = Zt / ((double)seriesR + 1.0 / (jw * (double)couplingC) + Zt);
+
+        return std::abs(Y / X - H) / std::abs(H);
+    }
+}
+
+
+int runWdfCheck()
+{
+    bool pass = true;
+
+    std::printf("diode pair root against DiodeClipper (exact), Vin in [-32, 32] V\n\n");
+    std::printf("%-14s %12s %12s %10s\n", "refine steps", "max err [V]", "bound", "ns/sample");
+
+    for (int steps = 0; steps <= 2; ++steps)
+    {
+        double error = curveError(steps);
+
+        wdf::ResistiveVoltageSource vs { seriesR };
+        wdf::DiodePair dp { vs, Is, nVt, steps };
+        double ns = nsPerSample([&](float x) { vs.setVoltage(x); dp.process(); return dp.voltage(); });
+
+        // fewer steps are printed for comparison, the default is checked
+        bool checked = steps == 2;
+        pass = pass && (!checked || error <= curveBound);
+
+        std::printf("%-14d %12.3g %12s %10.1f  %s\n", steps, error, checked ? "1e-06" : "-", ns,
+            checked ? (error <= curveBound ? "ok" : "FAIL") : "");
+    }
+
+    DiodeClipper clipper(seriesR, Is, nVt);
+    std::printf("%-14s %12s %12s %10.1f\n", "DiodeClipper", "", "", nsPerSample([&](float x) { return clipper.process(x); }));
+
+    std::printf("\nsmall-signal response, R %.0f k, Cc %.0f nF, Ct %.0f pF || diodes\n\n",
+        seriesR / 1000.0f, couplingC * 1e9f, toneC * 1e12f);
+    std::printf("%-14s %12s %12s\n", "freq [Hz]", "rel. error", "bound");
+
+    for (double frequency : { 100.0, 1000.0, 10000.0 })
+    {
+        double error = responseError(frequency);
+        pass = pass && error <= responseBound;
+        std::printf("%-14.0f %12.3g %12.0e  %s\n", frequency, error, responseBound, error <= responseBound ? "ok" : "FAIL");
+    }
+
+    wdf::ResistiveVoltageSource vs { seriesR };
+    wdf::Capacitor cc { couplingC, sampleRate };
+    wdf::Series s { vs, cc };
+    wdf::PolarityInverter inv { s };
+    wdf::Capacitor ct { toneC, sampleRate };
+    wdf::Parallel p { inv, ct };
+    wdf::DiodePair dp { p, Is, nVt };
+
+    std::printf("\ncoupled clipper: %.1f ns/sample\n", nsPerSample([&](float x) { vs.setVoltage(x); dp.process(); return ct.voltage(); }));
+
+    return pass ? 0 : 1;
+}
@@ -0,0 +1,18 @@
+/*
+  ==============================================================================
+
+    WdfCheck.h
+    Created: 22 Oct 2026 2:18:44pm
+    Author:  dkuzn
+
+  ==============================================================================
+*/
+
+#pragma once
+
+
+// WDF.h checks: the resistive source + diode pair tree against the DiodeClipper
+// curve (exact solve), the small-signal response of a clipper with coupling
+// and tone caps against its analytic transfer function, and cost per sample.
+// Returns 0 when both errors stay within their bounds.
+int runWdfCheck();
@@ -1,5 +1,6 @@
 import numpy as np
 import wave
+import struct
 import sys
 
 # test_tone params
@@ -10,13 +11,21 @@ num_tones = 3
 
 ampSteps = 100  # Numbers of measures points
 
+# testToneGen ramps 0.1 -> 0.8 and normalises the peak to full scale
+ampStart = 0.1 / 0.8
+ampStop = 1.0
+
+# tone of each band and the plugin's crossover between them (.dkap only)
+band_freqs = [200.0, 1000.0, 8000.0]
+crossover_freqs = [447.0, 2828.0]
+
 if len(sys.argv) < 4:
-    print("Use: python analyze_transfer.py test_tone.wav processed.wav output.h")
+    print("Use: python transitionGen.py test_tone.wav processed.wav output.h|output.dkap")
     sys.exit(1)
 
 file_ref = sys.argv[1]      # original test_tone.wav
 file_proc = sys.argv[2]     # processed file
-file_out = sys.argv[3]      # output .h
+file_out = sys.argv[3]      # output .h, or .dkap profile for the plugin
 
 
 def read_wav(filename):
@@ -65,23 +74,36 @@ for tone_idx in range(num_tones):
         tran[tone_idx, j] = ratio
 
 
-# save to .h file
-with open(file_out, "w") as f:
-    f.write(f"#ifndef TRANSFER_FUNCTION_H\n")
-    f.write(f"#define TRANSFER_FUNCTION_H\n\n")
-    f.write(f"#define AMP_STEPS {ampSteps}\n\n")
-    f.write("float tran[3][AMP_STEPS] = {\n")
-
-    for i in range(num_tones):
-        f.write("    {\n")
-        for j in range(ampSteps):
-            f.write(f"        {tran[i, j]:.6f},\n")
-        f.write("    }")
-        if i < num_tones - 1:
-            f.write(",\n")
-        else:
-            f.write("\n")
-
-    f.write("};\n\n#endif // TRANSFER_FUNCTION_H\n")
+# save to .dkap file (format in Source/AmpProfile.h), amplitude of a step is its centre
+if file_out.lower().endswith(".dkap"):
+    amp_min = ampStart + (ampStop - ampStart) * 0.5 / ampSteps
+    amp_max = ampStart + (ampStop - ampStart) * (ampSteps - 0.5) / ampSteps
+
+    with open(file_out, "wb") as f:
+        f.write(b"DKAP")
+        f.write(struct.pack("<III", 1, num_tones, ampSteps))
+        f.write(struct.pack("<ff", amp_min, amp_max))
+        f.write(struct.pack("<3f", *band_freqs))
+        f.write(struct.pack("<2f", *crossover_freqs))
+        f.write(tran.astype("<f4").tobytes())
+else:
+    # save to .h file
+    with open(file_out, "w") as f:
+        f.write(f"#ifndef TRANSFER_FUNCTION_H\n")
+        f.write(f"#define TRANSFER_FUNCTION_H\n\n")
+        f.write(f"#define AMP_STEPS {ampSteps}\n\n")
+        f.write("float tran[3][AMP_STEPS] = {\n")
+
+        for i in range(num_tones):
+            f.write("    {\n")
+            for j in range(ampSteps):
+                f.write(f"        {tran[i, j]:.6f},\n")
+            f.write("    }")
+            if i < num_tones - 1:
+                f.write(",\n")
+            else:
+                f.write("\n")
+
+        f.write("};\n\n#endif // TRANSFER_FUNCTION_H\n")
 
 print(f"Save to {file_out}")